@@ -0,0 +1,21 @@
+#include "BenchUtil.h"
+using namespace std;
+
+string randomDigits(mt19937_64& rng, size_t n){
+    string s(n, '0');
+    for (char& c : s) c = (char)('0' + rng() % 10);
+    s[0] = (char)('1' + rng() % 9);
+    return s;
+}
+
+bool parseList(const string& list, vector<string>& out){
+    size_t start = 0;
+    while (start <= list.size()){
+        size_t comma = list.find(',', start);
+        if (comma==string::npos) comma = list.size();
+        if (comma==start) return false;
+        out.push_back(list.substr(start, comma - start));
+        start = comma + 1;
+    }
+    return true;
+}
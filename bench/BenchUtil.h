@@ -0,0 +1,17 @@
+#pragma once
+#ifndef PYTHON_INTERPRETER_BENCH_UTIL_H
+#define PYTHON_INTERPRETER_BENCH_UTIL_H
+
+#include <random>
+#include <string>
+#include <vector>
+
+// Helpers shared by the bench programs.
+
+// n random decimal digits without a leading zero
+std::string randomDigits(std::mt19937_64& rng, size_t n);
+
+// Splits a comma-separated option value into out; false on an empty item.
+bool parseList(const std::string& list, std::vector<std::string>& out);
+
+#endif // PYTHON_INTERPRETER_BENCH_UTIL_H
@@ -0,0 +1,168 @@
+// Bignum microbenchmark: the int operations scripts spend their time in, at
+// operand sizes from 1 to 100,000 decimal digits, written as CSV so the
+// sizes where an algorithm stops scaling can be read off (or plotted).
+// Arithmetic goes through Interpreter::binary, the path both engines take
+// for operands past int64; parse and print are parseNumber and toString.
+//
+// Operands are random, positive and seeded, so runs are comparable:
+//   add, sub, mul        n digits by n digits
+//   floordiv, mod        2n digits by n digits (an n-digit quotient)
+//   parse, print         one n-digit number
+// Each cell repeats its operation until --min-time has passed; exponent is
+// the local growth rate against the previous size (1 linear, 2 quadratic).
+#include "BenchUtil.h"
+#include "Interpreter.h"
+#include <fstream>
+#include <iostream>
+using namespace std;
+
+namespace {
+
+enum Op { ADD, SUB, MUL, FLOORDIV, MOD, PARSE, PRINT, OPS };
+const char* const OP_NAMES[OPS] = {"add", "sub", "mul", "floordiv", "mod", "parse", "print"};
+
+struct Operands {
+    Value a, b, dividend;
+    string text; // a in decimal
+};
+
+Operands makeOperands(size_t digits){
+    mt19937_64 rng(digits);
+    Operands o;
+    o.text = randomDigits(rng, digits);
+    o.a = parseNumber(o.text);
+    o.b = parseNumber(randomDigits(rng, digits));
+    o.dividend = parseNumber(randomDigits(rng, 2 * digits));
+    return o;
+}
+
+// Everything an op produces is folded in here so no call can be dropped.
+size_t sink = 0;
+
+void runOp(Op op, const Operands& o){
+    switch (op){
+        case ADD: sink += Interpreter::binary(BinOp::Add, o.a, o.b).i.backend().size(); break;
+        case SUB: sink += Interpreter::binary(BinOp::Sub, o.a, o.b).i.backend().size(); break;
+        case MUL: sink += Interpreter::binary(BinOp::Mul, o.a, o.b).i.backend().size(); break;
+        case FLOORDIV: sink += Interpreter::binary(BinOp::FloorDiv, o.dividend, o.b).i.backend().size(); break;
+        case MOD: sink += Interpreter::binary(BinOp::Mod, o.dividend, o.b).i.backend().size(); break;
+        case PARSE: sink += parseNumber(o.text).i.backend().size(); break;
+        case PRINT: sink += toString(o.a).size(); break;
+        default: break;
+    }
+}
+
+// nanoseconds per op, doubling the batch until min_ns has been spent
+double timeOp(Op op, const Operands& o, double min_ns, uint64_t& iterations){
+    using Clock = chrono::steady_clock;
+    uint64_t batch = 1;
+    iterations = 0;
+    double spent = 0;
+    while (spent < min_ns){
+        Clock::time_point start = Clock::now();
+        for (uint64_t i = 0; i < batch; ++i) runOp(op, o);
+        spent += chrono::duration<double, nano>(Clock::now() - start).count();
+        iterations += batch;
+        if (spent * 4 < min_ns) batch *= 2;
+    }
+    return spent / iterations;
+}
+
+// 1, 2, 5, 10, 20, 50, ... up to max
+vector<size_t> sweep(size_t max){
+    vector<size_t> sizes;
+    for (size_t decade = 1; decade <= max; decade *= 10){
+        for (size_t step : {1, 2, 5}){
+            if (decade * step <= max) sizes.push_back(decade * step);
+        }
+    }
+    return sizes;
+}
+
+int usage(const char* argv0){
+    cerr << "usage: " << argv0 << " [--max-digits=N] [--digits=N,N,...] [--ops=add,sub,mul,floordiv,mod,parse,print]"
+         << " [--min-time=MS] [--out=FILE.csv]\n";
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, const char* argv[]){
+    size_t max_digits = 100000;
+    vector<size_t> sizes;
+    bool ops[OPS] = {};
+    bool any_op = false;
+    double min_ms = 50;
+    string out_path;
+    for (int i = 1; i < argc; ++i){
+        string arg = argv[i];
+        char* end = nullptr;
+        if (arg.rfind("--max-digits=", 0)==0){
+            max_digits = strtoull(arg.c_str() + 13, &end, 10);
+            if (*end || max_digits==0) return usage(argv[0]);
+        }else if (arg.rfind("--digits=", 0)==0){
+            vector<string> items;
+            if (!parseList(arg.substr(9), items)) return usage(argv[0]);
+            for (const string& item : items){
+                size_t n = strtoull(item.c_str(), &end, 10);
+                if (*end || n==0) return usage(argv[0]);
+                sizes.push_back(n);
+            }
+        }else if (arg.rfind("--ops=", 0)==0){
+            vector<string> items;
+            if (!parseList(arg.substr(6), items)) return usage(argv[0]);
+            for (const string& item : items){
+                int op = (int)(find(OP_NAMES, OP_NAMES + OPS, item) - OP_NAMES);
+                if (op==OPS) return usage(argv[0]);
+                ops[op] = any_op = true;
+            }
+        }else if (arg.rfind("--min-time=", 0)==0){
+            min_ms = strtod(arg.c_str() + 11, &end);
+            if (*end || !(min_ms > 0)) return usage(argv[0]);
+        }else if (arg.rfind("--out=", 0)==0){
+            out_path = arg.substr(6);
+            if (out_path.empty()) return usage(argv[0]);
+        }else{
+            return usage(argv[0]);
+        }
+    }
+    if (sizes.empty()) sizes = sweep(max_digits);
+    if (!any_op) fill(ops, ops + OPS, true);
+
+    ofstream file;
+    if (!out_path.empty()){
+        file.open(out_path);
+        if (!file){
+            cerr << "bench: cannot write " << out_path << '\n';
+            return 2;
+        }
+    }
+    ostream& out = out_path.empty() ? cout : file;
+    out << "op,digits,limbs,iterations,ns_per_op,exponent\n";
+    double last_ns[OPS] = {};
+    size_t last_digits = 0;
+    char buf[128];
+    for (size_t digits : sizes){
+        Operands o = makeOperands(digits);
+        if (toString(o.a)!=o.text){
+            cerr << "bench: " << digits << "-digit round trip through parseNumber and toString failed\n";
+            return 1;
+        }
+        for (int op = 0; op < OPS; ++op){
+            if (!ops[op]) continue;
+            uint64_t iterations;
+            double ns = timeOp((Op)op, o, min_ms * 1e6, iterations);
+            snprintf(buf, sizeof buf, "%s,%zu,%u,%llu,%.1f,", OP_NAMES[op], digits, o.a.i.backend().size(),
+                     (unsigned long long)iterations, ns);
+            out << buf;
+            if (last_digits && last_digits!=digits && last_ns[op] > 0){
+                snprintf(buf, sizeof buf, "%.2f", log(ns / last_ns[op]) / log((double)digits / last_digits));
+                out << buf;
+            }
+            out << '\n' << flush;
+            last_ns[op] = ns;
+        }
+        last_digits = digits;
+    }
+    return sink==0; // never true; keeps the results observable
+}
@@ -0,0 +1,309 @@
+// In-process benchmark over the bundled testcases. Every case is parsed and
+// run many times in this one process, with print's output captured, and the
+// parse, execute and print phases are timed separately:
+//   parse    lex + parse + optimize (+ compile to bytecode for --stackless)
+//   exec     the run, less the time spent inside print
+//   print    formatting and writing print's arguments
+// Each case's output is checked against its .out first. With --baseline each
+// case's best total time, and the suite's sum of them, are compared to a
+// stored run; any that got slower by more than the threshold fail the
+// benchmark. Best-of-N is what survives a noisy machine; medians are shown.
+#include "Builtins.h"
+#include "Compiler.h"
+#include "Frontend.h"
+#include "Interpreter.h"
+#include "VM.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace {
+
+enum Phase { PARSE, EXEC, PRINT, TOTAL, PHASES };
+const char* const PHASE_NAMES[PHASES] = {"parse", "exec", "print", "total"};
+
+// a slowdown under this many microseconds is noise whatever its percentage
+constexpr double NOISE_FLOOR_US = 50;
+
+struct Options {
+    bool use_antlr = false;
+    bool stackless = false;
+    bool jit = true;
+    int runs = 20;
+    int warmup = 2;
+    double threshold = 20; // percent
+    string baseline;
+    string write_baseline;
+    vector<string> dirs;
+};
+
+struct Summary {
+    double median = 0, mean = 0, stddev = 0, min = 0; // microseconds
+};
+
+struct Case {
+    string name; // directory/stem
+    string input;
+    string expected;
+    vector<double> samples[PHASES];
+    Summary phase[PHASES];
+    string error; // set when the case failed to run or printed the wrong output
+};
+
+Summary summarize(vector<double> samples){
+    Summary s;
+    if (samples.empty()) return s;
+    sort(samples.begin(), samples.end());
+    size_t n = samples.size();
+    s.median = n % 2 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+    s.min = samples[0];
+    for (double x : samples) s.mean += x;
+    s.mean /= n;
+    for (double x : samples) s.stddev += (x - s.mean) * (x - s.mean);
+    s.stddev = n > 1 ? sqrt(s.stddev / (n - 1)) : 0;
+    return s;
+}
+
+string readFile(const fs::path& path){
+    ifstream in(path, ios::binary);
+    return string(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+}
+
+vector<Case> loadCases(const vector<string>& dirs){
+    vector<Case> cases;
+    for (const string& dir : dirs){
+        vector<fs::path> inputs;
+        for (const fs::directory_entry& e : fs::directory_iterator(dir)){
+            if (e.path().extension()==".in") inputs.push_back(e.path());
+        }
+        sort(inputs.begin(), inputs.end());
+        for (const fs::path& in : inputs){
+            Case c;
+            c.name = fs::path(dir).filename().string() + "/" + in.stem().string();
+            c.input = readFile(in);
+            c.expected = readFile(fs::path(in).replace_extension(".out"));
+            cases.push_back(std::move(c));
+        }
+    }
+    return cases;
+}
+
+// Sends cout to a string for as long as it lives.
+class CaptureOutput {
+public:
+    CaptureOutput() : saved_(cout.rdbuf(out_.rdbuf())) {}
+    ~CaptureOutput() { cout.rdbuf(saved_); }
+    string str() const { return out_.str(); }
+
+private:
+    ostringstream out_;
+    streambuf* saved_;
+};
+
+double micros(chrono::steady_clock::duration d){
+    return chrono::duration<double, micro>(d).count();
+}
+
+// One parse and run of c; false (with c.error set) if it threw.
+bool runOnce(const Options& opt, Case& c, bool check){
+    using Clock = chrono::steady_clock;
+    uint64_t print_ns = 0;
+    string output;
+    Clock::time_point start = Clock::now(), parsed, done;
+    try {
+        Program program = parseSource(c.input, opt.use_antlr);
+        CaptureOutput capture;
+        print_clock_ns = &print_ns;
+        if (opt.stackless){
+            Module module = Compiler(program).compile();
+            parsed = Clock::now();
+            VM(program, module, VM::DEFAULT_STACK_BUDGET, opt.jit).run();
+        }else{
+            parsed = Clock::now();
+            Interpreter(program).run();
+        }
+        done = Clock::now();
+        print_clock_ns = nullptr;
+        if (check) output = capture.str();
+    }catch (const SyntaxError& e){
+        print_clock_ns = nullptr;
+        c.error = string("SyntaxError: ") + e.what();
+        return false;
+    }catch (const exception& e){
+        print_clock_ns = nullptr;
+        c.error = e.what();
+        return false;
+    }
+    if (check && output!=c.expected){
+        c.error = "output differs from the expected .out";
+        return false;
+    }
+    double print = print_ns / 1000.0;
+    c.samples[PARSE].push_back(micros(parsed - start));
+    c.samples[EXEC].push_back(micros(done - parsed) - print);
+    c.samples[PRINT].push_back(print);
+    c.samples[TOTAL].push_back(micros(done - start));
+    return true;
+}
+
+void runCase(const Options& opt, Case& c){
+    for (int i = 0; i < opt.warmup + opt.runs; ++i){
+        if (!runOnce(opt, c, i==0)) return;
+        if (i < opt.warmup){
+            for (vector<double>& s : c.samples) s.clear();
+        }
+    }
+    for (int p = 0; p < PHASES; ++p) c.phase[p] = summarize(c.samples[p]);
+}
+
+// case -> median microseconds per phase, then the best total
+using Baseline = map<string, array<double, PHASES + 1>>;
+
+bool readBaseline(const string& path, Baseline& baseline){
+    ifstream in(path);
+    if (!in) return false;
+    string line;
+    while (getline(in, line)){
+        if (line.empty() || line[0]=='#') continue;
+        istringstream fields(line);
+        string name;
+        array<double, PHASES + 1> times{};
+        fields >> name;
+        for (double& t : times) fields >> t;
+        if (fields) baseline[name] = times;
+    }
+    return true;
+}
+
+void writeBaseline(const string& path, const Options& opt, const vector<Case>& cases){
+    ofstream out(path);
+    if (!out){
+        cerr << "bench: cannot write " << path << '\n';
+        return;
+    }
+    out << "# bench_cases baseline: median microseconds per phase and the best total over " << opt.runs << " runs"
+        << (opt.use_antlr ? ", --engine=antlr" : "") << (opt.stackless ? ", --stackless" : "")
+        << (opt.stackless && !opt.jit ? " --no-jit" : "") << "\n# case";
+    for (const char* name : PHASE_NAMES) out << ' ' << name;
+    out << " best\n";
+    char buf[64];
+    for (const Case& c : cases){
+        if (!c.error.empty()) continue;
+        out << c.name;
+        for (const Summary& s : c.phase){
+            snprintf(buf, sizeof buf, " %.1f", s.median);
+            out << buf;
+        }
+        snprintf(buf, sizeof buf, " %.1f\n", c.phase[TOTAL].min);
+        out << buf;
+    }
+}
+
+bool regressed(double now, double before, double threshold){
+    return now > before * (1 + threshold / 100) && now - before > NOISE_FLOOR_US;
+}
+
+void report(const Options& opt, const vector<Case>& cases, const Baseline* baseline, bool& failed){
+    auto ms = [](double us){ return us / 1000; };
+    char buf[256];
+    snprintf(buf, sizeof buf, "%-36s %10s %10s %10s %10s %7s %10s %10s %8s\n", "case", "parse ms", "exec ms", "print ms",
+             "total ms", "sd%", "best ms", "was ms", "change");
+    cout << buf;
+    double totals[PHASES] = {}, base_total = 0, now_total = 0;
+    for (const Case& c : cases){
+        if (!c.error.empty()){
+            cout << c.name << ": FAILED: " << c.error << '\n';
+            failed = true;
+            continue;
+        }
+        for (int p = 0; p < PHASES; ++p) totals[p] += c.phase[p].median;
+        const Summary& t = c.phase[TOTAL];
+        snprintf(buf, sizeof buf, "%-36s %10.3f %10.3f %10.3f %10.3f %6.1f%% %10.3f", c.name.c_str(),
+                 ms(c.phase[PARSE].median), ms(c.phase[EXEC].median), ms(c.phase[PRINT].median), ms(t.median),
+                 t.mean > 0 ? 100 * t.stddev / t.mean : 0.0, ms(t.min));
+        cout << buf;
+        auto it = baseline ? baseline->find(c.name) : Baseline::const_iterator();
+        if (baseline && it!=baseline->end()){
+            double before = it->second[PHASES];
+            base_total += before;
+            now_total += t.min;
+            bool slower = regressed(t.min, before, opt.threshold);
+            snprintf(buf, sizeof buf, " %10.3f %+7.1f%%%s", ms(before), before > 0 ? 100 * (t.min / before - 1) : 0.0,
+                     slower ? "  REGRESSION" : "");
+            cout << buf;
+            failed |= slower;
+        }
+        cout << '\n';
+    }
+    snprintf(buf, sizeof buf, "%-36s %10.3f %10.3f %10.3f %10.3f\n", "sum", ms(totals[PARSE]),
+             ms(totals[EXEC]), ms(totals[PRINT]), ms(totals[TOTAL]));
+    cout << buf;
+    if (baseline && base_total > 0){
+        bool slower = regressed(now_total, base_total, opt.threshold);
+        snprintf(buf, sizeof buf, "suite best vs baseline: %.3f ms -> %.3f ms (%+.1f%%, threshold %.1f%%)%s\n",
+                 ms(base_total), ms(now_total), 100 * (now_total / base_total - 1), opt.threshold,
+                 slower ? "  REGRESSION" : "");
+        cout << buf;
+        failed |= slower;
+    }
+}
+
+int usage(const char* argv0){
+    cerr << "usage: " << argv0 << " [--engine=native|antlr] [--stackless [--no-jit]] [--runs=N] [--warmup=N]"
+         << " [--baseline=FILE] [--threshold=PERCENT] [--write-baseline=FILE] [testcase-dir...]\n";
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, const char* argv[]){
+    Options opt;
+    for (int i = 1; i < argc; ++i){
+        string arg = argv[i];
+        char* end = nullptr;
+        if (arg=="--engine=antlr") opt.use_antlr = true;
+        else if (arg=="--engine=native") opt.use_antlr = false;
+        else if (arg=="--stackless") opt.stackless = true;
+        else if (arg=="--no-jit") opt.jit = false;
+        else if (arg.rfind("--runs=", 0)==0){
+            opt.runs = (int)strtol(arg.c_str() + 7, &end, 10);
+            if (*end || opt.runs < 1) return usage(argv[0]);
+        }else if (arg.rfind("--warmup=", 0)==0){
+            opt.warmup = (int)strtol(arg.c_str() + 9, &end, 10);
+            if (*end || opt.warmup < 0) return usage(argv[0]);
+        }else if (arg.rfind("--threshold=", 0)==0){
+            opt.threshold = strtod(arg.c_str() + 12, &end);
+            if (*end || !(opt.threshold >= 0)) return usage(argv[0]);
+        }else if (arg.rfind("--baseline=", 0)==0) opt.baseline = arg.substr(11);
+        else if (arg.rfind("--write-baseline=", 0)==0) opt.write_baseline = arg.substr(17);
+        else if (arg.size() > 1 && arg[0]=='-') return usage(argv[0]);
+        else opt.dirs.push_back(arg);
+    }
+    if (opt.dirs.empty()){
+        opt.dirs = {BENCH_TESTCASES_DIR "/basic-testcases", BENCH_TESTCASES_DIR "/bigint-testcases"};
+    }
+
+    vector<Case> cases;
+    try {
+        cases = loadCases(opt.dirs);
+    }catch (const fs::filesystem_error& e){
+        cerr << "bench: " << e.what() << '\n';
+        return 2;
+    }
+    for (Case& c : cases) runCase(opt, c);
+
+    Baseline baseline;
+    bool compare = !opt.baseline.empty();
+    if (compare && !readBaseline(opt.baseline, baseline)){
+        cerr << "bench: cannot read " << opt.baseline << '\n';
+        return 2;
+    }
+    bool failed = false;
+    report(opt, cases, compare ? &baseline : nullptr, failed);
+    if (!opt.write_baseline.empty()) writeBaseline(opt.write_baseline, opt, cases);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,215 @@
+// Synthetic workload generator. The bundled testcases are tiny; this writes
+// programs in the same Python subset whose size and work grow with a scale
+// factor, each as NAME.in with the NAME.out a reference run printed, so a
+// directory of them can go straight to bench_cases or the interpreter.
+//
+//   recursion   non-tail, tail and mutual recursion; depth 200 x scale
+//   loops       an LCG while loop (20,000 x scale) and a nested loop
+//   literals    int literals of 100 x scale digits through + - * // %
+//   fstrings    200 x scale lines of f-string output
+//   functions   50 x scale defs, called in chains of up to ten
+//
+// The reference run parses with ANTLR (the conformance oracle) and executes
+// on the stackless VM without the JIT, so no depth is too deep for it.
+#include "BenchUtil.h"
+#include "Compiler.h"
+#include "Frontend.h"
+#include "VM.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace {
+
+string recursion(uint64_t scale){
+    uint64_t depth = 200 * scale;
+    // fib(n) makes about 1.6^n calls
+    uint64_t fib = 15 + (uint64_t)(log((double)scale) / log(1.618));
+    ostringstream p;
+    p << "# recursion x" << scale << "\n"
+      << "def depth(n):\n    if n == 0:\n        return 0\n    return depth(n - 1) + 1\n\n"
+      << "def count(n, acc=0):\n    if n == 0:\n        return acc\n    return count(n - 1, acc=acc + n)\n\n"
+      << "def is_even(n):\n    if n == 0:\n        return True\n    return is_odd(n - 1)\n\n"
+      << "def is_odd(n):\n    if n == 0:\n        return False\n    return is_even(n - 1)\n\n"
+      << "def fib(n):\n    if n < 2:\n        return n\n    return fib(n - 1) + fib(n - 2)\n\n"
+      << "print(depth(" << depth << "))\n"
+      << "print(count(" << 5 * depth << "))\n"
+      << "print(is_even(" << depth + 1 << "))\n"
+      << "print(fib(" << fib << "))\n";
+    return p.str();
+}
+
+string loops(uint64_t scale){
+    uint64_t n = 20000 * scale;
+    ostringstream p;
+    p << "# loops x" << scale << "\n"
+      << "x = 12345\ni = 0\ntotal = 0\n"
+      << "while i < " << n << ":\n"
+      << "    x = (x * 1103515245 + 12345) % 2147483648\n"
+      << "    if x % 3 == 0:\n        total += x // 7\n"
+      << "    elif x % 3 == 1:\n        total -= x % 1000\n"
+      << "    else:\n        total = total + 1\n"
+      << "    i += 1\n"
+      << "    if i % " << n / 10 << " == 0:\n        print(i, total)\n"
+      << "j = 0\nacc = 0\n"
+      << "while j < " << 100 * scale << ":\n"
+      << "    k = 0\n"
+      << "    while k < 100:\n"
+      << "        if k == 50:\n            k += 1\n            continue\n"
+      << "        acc = (acc + j * k) % 1000000007\n"
+      << "        k += 1\n"
+      << "    j += 1\n"
+      << "print(acc)\n";
+    return p.str();
+}
+
+string literals(uint64_t scale){
+    size_t n = 100 * scale;
+    mt19937_64 rng(scale);
+    ostringstream p;
+    p << "# literals x" << scale << "\n"
+      << "a = " << randomDigits(rng, n) << "\n"
+      << "b = " << randomDigits(rng, n) << "\n"
+      << "c = -" << randomDigits(rng, n) << "\n"
+      << "d = " << randomDigits(rng, (n + 1) / 2) << "\n"
+      << "e = int(\"" << randomDigits(rng, n) << "\")\n"
+      << "print(a + b)\nprint(a - b)\nprint(c + a)\nprint(a * b)\n"
+      << "print(a // d)\nprint(a % d)\nprint(c // d)\nprint(c % d)\n"
+      << "print(a * b // d % a)\nprint(e - a)\nprint(a > b, c < d, a == a + 0)\n";
+    return p.str();
+}
+
+string fstrings(uint64_t scale){
+    ostringstream p;
+    p << "# fstrings x" << scale << "\n"
+      << "name = \"item\"\nprice = 0.0\ni = 0\n"
+      << "while i < " << 200 * scale << ":\n"
+      << "    price = price + 0.25\n"
+      << "    print(f\"{name} {i}: qty={i % 7} price={price} even={i % 2 == 0} tag={\"t\" + str(i % 10)}\")\n"
+      << "    if i % 50 == 0:\n"
+      << "        print(f\"-- {i // 50} blocks, {i * 3 + 1} units, first={i == 0} --\")\n"
+      << "    i += 1\n";
+    return p.str();
+}
+
+string functions(uint64_t scale){
+    uint64_t count = 50 * scale;
+    ostringstream p;
+    p << "# functions x" << scale << "\n";
+    for (uint64_t i = 0; i < count; ++i){
+        p << "def f" << i << "(x, y=" << i % 13 + 1 << "):\n";
+        if (i % 10==0) p << "    return x * y + " << i << "\n\n";
+        else p << "    return f" << i - 1 << "(x + 1, y=y) - " << i % 7 << "\n\n";
+    }
+    p << "total = 0\n";
+    for (uint64_t i = 0; i < count; ++i){
+        p << "total = (total + f" << i << "(" << i % 100 << ")) % 1000000007\n";
+        if (i % 1000==999) p << "print(total)\n";
+    }
+    p << "print(total)\n";
+    return p.str();
+}
+
+struct Kind {
+    const char* name;
+    string (*generate)(uint64_t scale);
+};
+const Kind KINDS[] = {
+    {"recursion", recursion}, {"loops", loops}, {"literals", literals}, {"fstrings", fstrings},
+    {"functions", functions},
+};
+
+// What the reference configuration prints for source.
+string referenceOutput(const string& source){
+    Program program = parseSource(source, true);
+    Module module = Compiler(program).compile();
+    ostringstream out;
+    streambuf* saved = cout.rdbuf(out.rdbuf());
+    try {
+        VM(program, module, VM::DEFAULT_STACK_BUDGET, false).run();
+    }catch (...){
+        cout.rdbuf(saved);
+        throw;
+    }
+    cout.rdbuf(saved);
+    return out.str();
+}
+
+int usage(const char* argv0){
+    cerr << "usage: " << argv0 << " [--scales=1,10,100,1000] [--kinds=recursion,loops,literals,fstrings,functions]"
+         << " [--no-expected] OUTDIR\n";
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, const char* argv[]){
+    vector<uint64_t> scales = {1, 10, 100, 1000};
+    vector<const Kind*> kinds;
+    bool expected = true;
+    string dir;
+    for (int i = 1; i < argc; ++i){
+        string arg = argv[i];
+        vector<string> items;
+        if (arg.rfind("--scales=", 0)==0){
+            if (!parseList(arg.substr(9), items)) return usage(argv[0]);
+            scales.clear();
+            for (const string& item : items){
+                char* end = nullptr;
+                uint64_t scale = strtoull(item.c_str(), &end, 10);
+                if (*end || scale==0) return usage(argv[0]);
+                scales.push_back(scale);
+            }
+        }else if (arg.rfind("--kinds=", 0)==0){
+            if (!parseList(arg.substr(8), items)) return usage(argv[0]);
+            for (const string& item : items){
+                const Kind* kind = find_if(begin(KINDS), end(KINDS), [&](const Kind& k){ return item==k.name; });
+                if (kind==end(KINDS)) return usage(argv[0]);
+                kinds.push_back(kind);
+            }
+        }else if (arg=="--no-expected") expected = false;
+        else if (arg.size() > 1 && arg[0]=='-') return usage(argv[0]);
+        else if (dir.empty()) dir = arg;
+        else return usage(argv[0]);
+    }
+    if (dir.empty()) return usage(argv[0]);
+    if (kinds.empty()){
+        for (const Kind& k : KINDS) kinds.push_back(&k);
+    }
+
+    error_code ec;
+    fs::create_directories(dir, ec);
+    if (ec){
+        cerr << "gen: cannot create " << dir << ": " << ec.message() << '\n';
+        return 2;
+    }
+    char buf[160];
+    snprintf(buf, sizeof buf, "%-24s %12s %12s %12s\n", "workload", "in bytes", "out bytes", "reference ms");
+    cout << buf;
+    for (const Kind* kind : kinds){
+        for (uint64_t scale : scales){
+            string name = string(kind->name) + "_x" + to_string(scale);
+            string source = kind->generate(scale);
+            ofstream(fs::path(dir) / (name + ".in"), ios::binary) << source;
+            string output;
+            double ms = 0;
+            if (expected){
+                auto start = chrono::steady_clock::now();
+                try {
+                    output = referenceOutput(source);
+                }catch (const exception& e){
+                    cerr << "gen: " << name << ": reference run failed: " << e.what() << '\n';
+                    return 1;
+                }
+                ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+                ofstream(fs::path(dir) / (name + ".out"), ios::binary) << output;
+            }
+            snprintf(buf, sizeof buf, "%-24s %12zu %12zu %12.1f\n", name.c_str(), source.size(), output.size(), ms);
+            cout << buf << flush;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,96 @@
+#pragma once
+#ifndef PYTHON_INTERPRETER_AST_H
+#define PYTHON_INTERPRETER_AST_H
+
+#include "Value.h"
+
+using NodeId = uint32_t;
+constexpr NodeId NO_NODE = UINT32_MAX;
+
+enum class NodeKind : uint8_t {
+    // expressions
+    Const,    // a = constant index
+    Name,     // a = name index
+    FString,  // list = parts (string constants and expressions)
+    Tuple,    // list = elements of a testlist with more than one test
+    Unary,    // op = UnaryOp, a = operand
+    Not,      // a = operand
+    Binary,   // op = BinOp, a = lhs, b = rhs; first = k for the *Pow2 ops
+    And,      // list = operands
+    Or,       // list = operands
+    Compare,  // list = x0, op1, x1, op2, x2, ... (ops stored as CmpOp values)
+    Call,     // a = callee name index, or b = callee expression if it is not a NAME; list = arguments
+    Keyword,  // a = keyword name index (NO_NODE if not a NAME), b = value
+    // statements
+    Block,    // list = statements
+    ExprStmt, // a = expression
+    Assign,   // list = targets..., value (last)
+    AugAssign,// op = BinOp, a = target, b = value; first = k for the *Pow2 ops
+    If,       // list = cond0, body0, cond1, body1, ...; b = else body or NO_NODE
+    While,    // a = condition, b = body
+    Break,
+    Continue,
+    Return,   // a = value or NO_NODE
+    FuncDef,  // a = name index, b = body, list = Param nodes
+    Param,    // a = name index, b = default value or NO_NODE
+};
+
+enum class UnaryOp : uint8_t { Neg, Pos };
+enum class BinOp : uint8_t {
+    Add, Sub, Mul, Div, FloorDiv, Mod,
+    // introduced by the Optimizer for a constant divisor b == 2**k (k < 64):
+    // ints use an arithmetic shift / low-bit mask, other types fall back
+    FloorDivPow2, ModPow2,
+};
+enum class CmpOp : uint8_t { Lt, Gt, Eq, Ge, Le, Ne };
+
+// 24-byte node; children are indices into the owning Program, never pointers.
+struct Node {
+    NodeKind kind;
+    uint8_t op = 0;
+    uint32_t line = 0;
+    uint32_t a = NO_NODE;
+    uint32_t b = NO_NODE;
+    uint32_t first = 0; // child list is lists[first, first + count)
+    uint32_t count = 0;
+};
+
+// The whole syntax tree of a script lives in these few vectors.
+struct Program {
+    std::vector<Node> nodes;
+    std::vector<NodeId> lists;
+    std::vector<Value> constants;
+    std::vector<std::string> names; // symbol table: a name index is the identifier's symbol id
+    std::unordered_map<std::string, uint32_t> symbols;
+    NodeId root = NO_NODE;
+
+    const Node& operator[](NodeId id) const { return nodes[id]; }
+    NodeId child(const Node& n, size_t i) const { return lists[n.first + i]; }
+
+    NodeId add(NodeKind kind, uint32_t line, uint32_t a = NO_NODE, uint32_t b = NO_NODE, uint8_t op = 0){
+        Node n; n.kind = kind; n.op = op; n.line = line; n.a = a; n.b = b;
+        nodes.push_back(n);
+        return (NodeId)(nodes.size() - 1);
+    }
+    void setList(NodeId id, const std::vector<NodeId>& children){
+        nodes[id].first = (uint32_t)lists.size();
+        nodes[id].count = (uint32_t)children.size();
+        lists.insert(lists.end(), children.begin(), children.end());
+    }
+    uint32_t addConstant(Value v){
+        constants.push_back(std::move(v));
+        return (uint32_t)(constants.size() - 1);
+    }
+    // identifiers are interned, so equal names always share one symbol id
+    uint32_t addName(std::string_view name){
+        auto [it, inserted] = symbols.emplace(std::string(name), (uint32_t)names.size());
+        if (inserted) names.push_back(it->first);
+        return it->second;
+    }
+    uint32_t findName(std::string_view name) const{
+        auto it = symbols.find(std::string(name));
+        return it==symbols.end() ? NO_NODE : it->second;
+    }
+};
+
+#endif // PYTHON_INTERPRETER_AST_H
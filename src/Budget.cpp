@@ -0,0 +1,27 @@
+#include "Budget.h"
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+using namespace std;
+
+Budget::Budget(uint64_t max_steps, double seconds) : max_steps_(max_steps), seconds_(seconds), start_(Clock::now()){
+    schedule();
+}
+
+void Budget::schedule(){
+    next_check_ = max_steps_ ? max_steps_ : UINT64_MAX;
+    if (seconds_ > 0 && used_ + CLOCK_EVERY < next_check_) next_check_ = used_ + CLOCK_EVERY;
+}
+
+void Budget::check(){
+    if (max_steps_ && used_ > max_steps_)
+        throw runtime_error("TimeoutError: step budget of " + to_string(max_steps_) + " exhausted");
+    double elapsed = chrono::duration<double>(Clock::now() - start_).count();
+    if (seconds_ > 0 && elapsed > seconds_){
+        char buf[64];
+        snprintf(buf, sizeof buf, "%g", seconds_);
+        throw runtime_error(string("TimeoutError: time limit of ") + buf + " s exceeded after " + to_string(used_)
+                            + " steps");
+    }
+    schedule();
+}
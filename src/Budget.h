@@ -0,0 +1,38 @@
+#pragma once
+#ifndef PYTHON_INTERPRETER_BUDGET_H
+#define PYTHON_INTERPRETER_BUDGET_H
+
+#include <chrono>
+#include <cstdint>
+
+// Execution limits (--max-steps=N, --time-limit=SECONDS). A step is one taken
+// loop back-edge or one user function call, so a script's step count is the
+// same in both engines, with or without the JIT, on any machine. Engines
+// spend steps exactly where they happen; the clock is read only every
+// CLOCK_EVERY steps. Running out throws a TimeoutError.
+class Budget {
+public:
+    using Clock = std::chrono::steady_clock;
+    static constexpr uint64_t CLOCK_EVERY = 4096;
+
+    // 0 means no limit of that kind
+    Budget(uint64_t max_steps, double seconds);
+
+    void step() { if (++used_ > next_check_) check(); }
+    void spend(uint64_t steps) { used_ += steps; if (used_ > next_check_) check(); }
+    // steps that can be spent before one is due to be checked
+    uint64_t allowance() const { return next_check_ - used_; }
+    uint64_t used() const { return used_; }
+
+private:
+    uint64_t max_steps_;
+    double seconds_;
+    Clock::time_point start_;
+    uint64_t used_ = 0;
+    uint64_t next_check_ = 0; // the last step count allowed without a check
+
+    void check();
+    void schedule();
+};
+
+#endif // PYTHON_INTERPRETER_BUDGET_H
@@ -0,0 +1,54 @@
+#include "Builtins.h"
+#include <chrono>
+using boost::multiprecision::cpp_int;
+using namespace std;
+
+Builtin builtinOf(string_view name){
+    if (name == "print") return Builtin::Print;
+    if (name == "int") return Builtin::Int;
+    if (name == "float") return Builtin::Float;
+    if (name == "str") return Builtin::Str;
+    if (name == "bool") return Builtin::Bool;
+    return Builtin::None;
+}
+
+uint64_t* print_clock_ns = nullptr;
+
+static void print(const Value* args, size_t count){
+    // print all args with space separator
+    for (size_t i=0;i<count;++i){ if (i) cout<<' '; cout<<toString(args[i]); }
+    cout<<'\n';
+}
+
+Value callBuiltin(Builtin b, Value* args, size_t count){
+    if (b == Builtin::Print){
+        if (!print_clock_ns){
+            print(args, count);
+            return Value::None();
+        }
+        auto start = chrono::steady_clock::now();
+        print(args, count);
+        *print_clock_ns += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+        return Value::None();
+    }
+    if (count!=1) return Value::None();
+    Value& v = args[0];
+    if (b == Builtin::Int){
+        if (v.type==Value::Type::INT) return std::move(v);
+        if (v.type==Value::Type::BOOL) return Value::fromInt(v.b?1:0);
+        if (v.type==Value::Type::FLOAT) return Value::fromInt((cpp_int) (v.f>=0? floor(v.f): ceil(v.f))); // truncate toward zero
+        if (v.type==Value::Type::STR) return parseNumber(v.s);
+        return Value::fromInt(0);
+    }else if (b == Builtin::Float){
+        if (v.type==Value::Type::FLOAT) return v;
+        if (v.type==Value::Type::INT) return Value::fromFloat(v.i.convert_to<double>());
+        if (v.type==Value::Type::BOOL) return Value::fromFloat(v.b?1.0:0.0);
+        if (v.type==Value::Type::STR) return Value::fromFloat(strtod(v.s.c_str(), nullptr));
+        return Value::fromFloat(0.0);
+    }else if (b == Builtin::Str){
+        if (v.type==Value::Type::STR) return std::move(v);
+        return Value::fromStr(toString(v));
+    }else { // bool
+        return Value::fromBool(isTruthy(v));
+    }
+}
@@ -0,0 +1,21 @@
+#pragma once
+#ifndef PYTHON_INTERPRETER_BUILTINS_H
+#define PYTHON_INTERPRETER_BUILTINS_H
+
+#include "Value.h"
+
+// Builtin functions. Every execution engine resolves callee symbols to one of
+// these once and then calls through the id; a builtin shadows any user def.
+enum class Builtin : uint8_t { None, Print, Int, Float, Str, Bool };
+
+Builtin builtinOf(std::string_view name);
+
+// args[0..count) are the evaluated arguments in call order (keyword names are
+// irrelevant to builtins); they may be moved from.
+Value callBuiltin(Builtin b, Value* args, size_t count);
+
+// While set, print adds the nanoseconds it spends formatting and writing to
+// *print_clock_ns (the benchmark harness splits print from execution time).
+extern uint64_t* print_clock_ns;
+
+#endif // PYTHON_INTERPRETER_BUILTINS_H
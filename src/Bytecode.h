@@ -0,0 +1,108 @@
+#pragma once
+#ifndef PYTHON_INTERPRETER_BYTECODE_H
+#define PYTHON_INTERPRETER_BYTECODE_H
+
+#include "Ast.h"
+
+// Stack-machine instruction set executed by the VM. Operands are named after
+// the Instr fields they use; "pop"/"push" refer to the value stack.
+enum class Op : uint8_t {
+    Const,         // push constants[a]
+    LoadGlobal,    // push global a (None if unbound)
+    LoadLocal,     // push slot a if bound, else global b
+    StoreGlobal,   // pop into global a
+    StoreLocal,    // pop into slot a if bound or global b unbound, else into global b
+    Peek,          // push a copy of the value a places below the top
+    Pop,
+    Unary,         // x = op(x); aux = UnaryOp
+    Not,
+    Binary,        // pop rhs, lhs; push lhs op rhs; aux = BinOp, a = k for the *Pow2 ops,
+                   // b = 1 if the operands were pushed the other way round
+    // type-specialized forms, emitted only where TypeInference proved the operand types
+    BinaryInt,     // like Binary with two ints (aux = BinOp other than Div)
+    BinarySmall,   // BinaryInt proven to stay within int64; runs unboxed, guarded
+    BinaryFloat,   // like Binary with two floats (aux = Add, Sub, Mul or Div)
+    ConcatStr,     // str + str; b as for Binary
+    Compare,       // pop rhs, lhs; push bool; aux = CmpOp
+    CompareInt,    // Compare of two ints
+    CompareSmall,  // CompareInt of two ints proven to fit an int64
+    CompareChain,  // pop rhs, lhs; if false push False and jump a, else push rhs
+    JumpIfFalseOrPop, // and: if top is falsy jump a keeping it, else pop
+    JumpIfTrueOrPop,  // or
+    Jump,          // pc = a
+    JumpIfFalse,   // pop; if falsy pc = a
+    FString,       // pop a values, push their concatenated str()
+    Call,          // call site a: pops its arguments, pushes the result; aux = 1 in tail position
+    Return,        // pop the result and leave the frame
+    MakeFunction,  // pop b defaults; bind function unit a to its name
+    Fail,          // raise runtime_error(constants[a].s)
+    // written by the VM when it inlines a hot call (see VM::tryInline)
+    Inlined,       // call site a whose callee body was copied to pc b; guarded by its def version
+    InlineReturn,  // keep the top value, drop the a values beneath it, pc = b; not a
+                   // loop back-edge although b is behind it
+    // superinstructions for the statement shapes that dominate the testcases'
+    // dynamic instruction counts; b and c are Operand references, spec says
+    // what TypeInference proved about the operands
+    BinaryOperands, // push b op c; aux = BinOp, a = k for the *Pow2 ops
+    AugLocal,       // slot a op= c, read and stored like LoadLocal / StoreLocal; aux = BinOp, b = k
+    AugGlobal,      // global a op= c; aux = BinOp, b = k
+    CompareJump,    // if not (b op c) pc = a; aux = CmpOp, b may be Operand::TOP
+    // written by the VM over a hot loop's backward Jump (see LoopJit)
+    LoopNative,     // pc = a, then run the loop as native loop b if its vars allow
+};
+
+// Where a superinstruction operand lives: the top two bits pick the kind,
+// the rest is the index.
+struct Operand {
+    static constexpr uint32_t CONST = 0u << 30;  // constants[index]
+    static constexpr uint32_t LOCAL = 1u << 30;  // slot, falling back to its global like LoadLocal
+    static constexpr uint32_t GLOBAL = 2u << 30; // global symbol
+    static constexpr uint32_t PEEK = 3u << 30;   // index places below the stack top (inlined code)
+    static constexpr uint32_t KIND = 3u << 30;
+    static constexpr uint32_t TOP = NO_NODE;     // popped off the stack
+};
+
+enum class Spec : uint8_t {
+    Generic, // any operand types
+    Int,     // both ints
+    Small,   // both ints, operands and result proven to fit an int64
+};
+
+struct Instr {
+    Op op;
+    uint8_t aux = 0;
+    Spec spec = Spec::Generic;
+    uint32_t a = 0;
+    uint32_t b = 0;
+    uint32_t c = 0;
+};
+
+// Call sites keep their argument shape out of line; names[i] is the keyword
+// symbol of argument i, or POSITIONAL / UNNAMED_KEYWORD.
+struct CallSite {
+    static constexpr uint32_t POSITIONAL = NO_NODE;
+    static constexpr uint32_t UNNAMED_KEYWORD = NO_NODE - 1;
+
+    uint32_t callee = NO_NODE; // symbol; NO_NODE if the callee is not a NAME
+    std::vector<uint32_t> names;
+};
+
+// One compiled body: the module or a def. Function locals live in numbered
+// slots; params take slots 0..params.size()-1 in order of first appearance.
+struct CodeUnit {
+    std::vector<Instr> code;
+    std::vector<uint32_t> lines;     // source line per instruction
+    uint32_t name = NO_NODE;         // def name symbol (NO_NODE for the module)
+    std::vector<uint32_t> params;    // parameter symbols
+    std::vector<uint32_t> param_slots; // slot of each parameter
+    size_t required_count = 0;
+    std::vector<uint32_t> slot_symbols; // symbol of every slot
+};
+
+// Constants and symbols stay in the Program the module was compiled from.
+struct Module {
+    std::vector<CodeUnit> units; // units[0] is the module body
+    std::vector<CallSite> calls;
+};
+
+#endif // PYTHON_INTERPRETER_BYTECODE_H
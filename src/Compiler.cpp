@@ -0,0 +1,406 @@
+#include "Compiler.h"
+using namespace std;
+
+Module Compiler::compile(){
+    facts_ = TypeInference(prog_).run();
+    none_ = constant(Value::None());
+    mod_.units.emplace_back();
+    unit_ = 0;
+    stmt(prog_.root);
+    emit(Op::Const, none_);
+    emit(Op::Return);
+    // nested defs may queue further units while being compiled
+    while (!pending_.empty()){
+        auto [index, def] = pending_.back();
+        pending_.pop_back();
+        compileFunction(index, def);
+    }
+    return std::move(mod_);
+}
+
+size_t Compiler::emit(Op op, uint32_t a, uint32_t b, uint8_t aux, uint32_t c, Spec spec){
+    Instr in;
+    in.op = op; in.aux = aux; in.spec = spec; in.a = a; in.b = b; in.c = c;
+    unit().code.push_back(in);
+    unit().lines.push_back(line_);
+    return unit().code.size() - 1;
+}
+
+void Compiler::compileFunction(uint32_t index, NodeId def){
+    const Node& n = prog_[def];
+    unit_ = index;
+    slots_.clear();
+    loops_.clear();
+    line_ = n.line;
+    CodeUnit& u = unit();
+    u.name = n.a;
+    for (uint32_t i = 0; i < n.count; ++i){
+        const Node& p = prog_[prog_.child(n, i)];
+        u.params.push_back(p.a);
+        u.param_slots.push_back(slotFor(p.a));
+        if (p.b==NO_NODE) u.required_count = i + 1;
+    }
+    collectSlots(n.b);
+    stmt(n.b);
+    emit(Op::Const, none_);
+    emit(Op::Return);
+}
+
+uint32_t Compiler::slotFor(uint32_t sym){
+    auto [it, inserted] = slots_.emplace(sym, (uint32_t)slots_.size());
+    if (inserted) unit().slot_symbols.push_back(sym);
+    return it->second;
+}
+
+// Every name a def body assigns may become a local of the call.
+void Compiler::collectSlots(NodeId id){
+    const Node& n = prog_[id];
+    switch (n.kind){
+        case NodeKind::Block:
+            for (uint32_t i = 0; i < n.count; ++i) collectSlots(prog_.child(n, i));
+            return;
+        case NodeKind::Assign:
+            for (uint32_t i = 0; i + 1 < n.count; ++i){
+                const Node& t = prog_[prog_.child(n, i)];
+                if (t.kind==NodeKind::Name) slotFor(t.a);
+                else if (t.kind==NodeKind::Tuple){
+                    for (uint32_t j = 0; j < t.count; ++j){
+                        const Node& e = prog_[prog_.child(t, j)];
+                        if (e.kind==NodeKind::Name) slotFor(e.a);
+                    }
+                }
+            }
+            return;
+        case NodeKind::AugAssign:
+            if (prog_[n.a].kind==NodeKind::Name) slotFor(prog_[n.a].a);
+            return;
+        case NodeKind::If:
+            for (uint32_t i = 1; i < n.count; i += 2) collectSlots(prog_.child(n, i));
+            if (n.b!=NO_NODE) collectSlots(n.b);
+            return;
+        case NodeKind::While:
+            collectSlots(n.b);
+            return;
+        default:
+            return; // nested defs bind functions, not variables
+    }
+}
+
+void Compiler::load(uint32_t sym){
+    auto it = slots_.find(sym);
+    if (it!=slots_.end()) emit(Op::LoadLocal, it->second, sym);
+    else emit(Op::LoadGlobal, sym);
+}
+
+void Compiler::store(uint32_t sym){
+    auto it = slots_.find(sym);
+    if (it!=slots_.end()) emit(Op::StoreLocal, it->second, sym);
+    else emit(Op::StoreGlobal, sym);
+}
+
+void Compiler::fail(const char* message){
+    emit(Op::Fail, constant(Value::fromStr(message)));
+}
+
+// Statements
+void Compiler::stmt(NodeId id){
+    const Node& n = prog_[id];
+    line_ = n.line;
+    switch (n.kind){
+        case NodeKind::Block:
+            for (uint32_t i = 0; i < n.count; ++i) stmt(prog_.child(n, i));
+            return;
+        case NodeKind::ExprStmt:
+            expr(n.a);
+            emit(Op::Pop);
+            return;
+        case NodeKind::Assign:
+            assign(n);
+            return;
+        case NodeKind::AugAssign: {
+            const Node& target = prog_[n.a];
+            if (target.kind!=NodeKind::Name){ fail("invalid augmented assignment target"); return; }
+            uint32_t value;
+            if (operand(n.b, value)){
+                Spec sp = (BinOp)n.op==BinOp::Div ? Spec::Generic : spec(facts_[n.a], facts_[n.b], &facts_[id]);
+                auto it = slots_.find(target.a);
+                if (it!=slots_.end()) emit(Op::AugLocal, it->second, n.first, n.op, value, sp);
+                else emit(Op::AugGlobal, target.a, n.first, n.op, value, sp);
+                return;
+            }
+            // the value is evaluated before the target is read
+            expr(n.b);
+            load(target.a);
+            binary((BinOp)n.op, n.first, facts_[n.a], facts_[n.b], facts_[id], true);
+            store(target.a);
+            return;
+        }
+        case NodeKind::If: {
+            vector<size_t> ends;
+            for (uint32_t i = 0; i + 1 < n.count; i += 2){
+                size_t skip = branchIfFalse(prog_.child(n, i));
+                stmt(prog_.child(n, i + 1));
+                ends.push_back(emit(Op::Jump));
+                patch(skip);
+            }
+            if (n.b!=NO_NODE) stmt(n.b);
+            for (size_t at : ends) patch(at);
+            return;
+        }
+        case NodeKind::While: {
+            loops_.push_back({here(), {}});
+            size_t exit = branchIfFalse(n.a);
+            stmt(n.b);
+            emit(Op::Jump, loops_.back().top);
+            patch(exit);
+            for (size_t at : loops_.back().breaks) patch(at);
+            loops_.pop_back();
+            return;
+        }
+        case NodeKind::Break:
+            // outside a loop, break and continue end the body like a bare return
+            if (loops_.empty()){ emit(Op::Const, none_); emit(Op::Return); }
+            else loops_.back().breaks.push_back(emit(Op::Jump));
+            return;
+        case NodeKind::Continue:
+            if (loops_.empty()){ emit(Op::Const, none_); emit(Op::Return); }
+            else emit(Op::Jump, loops_.back().top);
+            return;
+        case NodeKind::Return:
+            if (n.a==NO_NODE) emit(Op::Const, none_);
+            else expr(n.a, true);
+            emit(Op::Return);
+            return;
+        case NodeKind::FuncDef: {
+            uint32_t ndefaults = 0;
+            size_t required = 0;
+            for (uint32_t i = 0; i < n.count; ++i){
+                if (prog_[prog_.child(n, i)].b==NO_NODE) required = i + 1;
+            }
+            for (size_t i = required; i < n.count; ++i, ++ndefaults){
+                const Node& p = prog_[prog_.child(n, (uint32_t)i)];
+                if (p.b==NO_NODE) emit(Op::Const, none_);
+                else expr(p.b);
+            }
+            uint32_t index = (uint32_t)mod_.units.size();
+            mod_.units.emplace_back();
+            pending_.push_back({index, id});
+            emit(Op::MakeFunction, index, ndefaults);
+            return;
+        }
+        default:
+            throw runtime_error("not a statement");
+    }
+}
+
+// a = b = ... = value; tuple targets unpack element-wise
+void Compiler::assign(const Node& n){
+    const Node& value = prog_[prog_.child(n, n.count - 1)];
+    uint32_t m = 1;
+    if (value.kind==NodeKind::Tuple){
+        m = value.count;
+        for (uint32_t i = 0; i < m; ++i) expr(prog_.child(value, i));
+    }else{
+        expr(prog_.child(n, n.count - 1));
+    }
+    for (uint32_t i = 0; i + 1 < n.count; ++i){
+        const Node& t = prog_[prog_.child(n, i)];
+        if (t.kind==NodeKind::Name && n.count==2 && m==1){
+            store(t.a); // the only target takes the value itself
+            return;
+        }
+        if (t.kind==NodeKind::Name){
+            emit(Op::Peek, 0);
+            store(t.a);
+        }else if (t.kind==NodeKind::Tuple && t.count==m){
+            for (uint32_t j = 0; j < t.count; ++j){
+                const Node& e = prog_[prog_.child(t, j)];
+                if (e.kind!=NodeKind::Name){ fail("invalid assignment target"); break; }
+                emit(Op::Peek, m - 1 - j);
+                store(e.a);
+            }
+        }else{
+            fail("invalid assignment target");
+        }
+    }
+    for (uint32_t i = 0; i < m; ++i) emit(Op::Pop);
+}
+
+// Expressions: each leaves exactly one value on the stack.
+void Compiler::expr(NodeId id, bool tail){
+    const Node& n = prog_[id];
+    switch (n.kind){
+        case NodeKind::Const: emit(Op::Const, n.a); return;
+        case NodeKind::Name: load(n.a); return;
+        case NodeKind::FString:
+            for (uint32_t i = 0; i < n.count; ++i) expr(prog_.child(n, i));
+            emit(Op::FString, n.count);
+            return;
+        case NodeKind::Tuple:
+            // a bare testlist evaluates every element and yields the last one
+            for (uint32_t i = 0; i < n.count; ++i){
+                if (i) emit(Op::Pop);
+                expr(prog_.child(n, i));
+            }
+            return;
+        case NodeKind::Unary:
+            expr(n.a);
+            emit(Op::Unary, 0, 0, n.op);
+            return;
+        case NodeKind::Not:
+            expr(n.a);
+            emit(Op::Not);
+            return;
+        case NodeKind::Binary: {
+            NodeId same = identityOperand(n);
+            if (same!=NO_NODE){
+                expr(same);
+                return;
+            }
+            uint32_t lhs, rhs;
+            if (operand(n.a, lhs) && operand(n.b, rhs)){
+                Spec sp = (BinOp)n.op==BinOp::Div ? Spec::Generic : spec(facts_[n.a], facts_[n.b], &facts_[id]);
+                emit(Op::BinaryOperands, n.first, lhs, n.op, rhs, sp);
+                return;
+            }
+            expr(n.a);
+            expr(n.b);
+            binary((BinOp)n.op, n.first, facts_[n.a], facts_[n.b], facts_[id], false);
+            return;
+        }
+        case NodeKind::And: case NodeKind::Or: {
+            // short-circuit; yields the deciding operand like Python
+            Op jump = n.kind==NodeKind::And ? Op::JumpIfFalseOrPop : Op::JumpIfTrueOrPop;
+            vector<size_t> ends;
+            for (uint32_t i = 0; i < n.count; ++i){
+                expr(prog_.child(n, i));
+                if (i + 1 < n.count) ends.push_back(emit(jump));
+            }
+            for (size_t at : ends) patch(at);
+            return;
+        }
+        case NodeKind::Compare: {
+            vector<size_t> ends;
+            expr(prog_.child(n, 0));
+            for (uint32_t i = 1; i + 1 < n.count; i += 2){
+                expr(prog_.child(n, i + 1));
+                uint8_t op = (uint8_t)prog_.child(n, i);
+                if (i + 2 < n.count) ends.push_back(emit(Op::CompareChain, 0, 0, op));
+                else{
+                    const Fact& lhs = facts_[prog_.child(n, i - 1)];
+                    const Fact& rhs = facts_[prog_.child(n, i + 1)];
+                    Op code = Op::Compare;
+                    if (lhs.type==StaticType::Int && rhs.type==StaticType::Int)
+                        code = lhs.range.bounded() && rhs.range.bounded() ? Op::CompareSmall : Op::CompareInt;
+                    emit(code, 0, 0, op);
+                }
+            }
+            for (size_t at : ends) patch(at);
+            return;
+        }
+        case NodeKind::Call: call(n, tail); return;
+        default:
+            throw runtime_error("not an expression");
+    }
+}
+
+void Compiler::binary(BinOp op, uint32_t k, const Fact& lhs, const Fact& rhs, const Fact& result, bool swapped){
+    Op code = Op::Binary;
+    if (lhs.type==StaticType::Int && rhs.type==StaticType::Int && op!=BinOp::Div){
+        bool small = lhs.range.bounded() && rhs.range.bounded() && result.range.bounded();
+        code = small ? Op::BinarySmall : Op::BinaryInt;
+    }else if (lhs.type==StaticType::Float && rhs.type==StaticType::Float
+             && (op==BinOp::Add || op==BinOp::Sub || op==BinOp::Mul || op==BinOp::Div)) code = Op::BinaryFloat;
+    else if (lhs.type==StaticType::Str && rhs.type==StaticType::Str && op==BinOp::Add) code = Op::ConcatStr;
+    emit(code, k, swapped ? 1 : 0, (uint8_t)op);
+}
+
+// x * 1, 1 * x, x + 0, 0 + x and x - 0 compile to x alone when x is proven
+// an int; for other types they are not identities (True + 0 is 1).
+NodeId Compiler::identityOperand(const Node& n) const{
+    auto isInt = [&](NodeId id, long long v){
+        const Node& c = prog_[id];
+        return c.kind==NodeKind::Const && prog_.constants[c.a].type==Value::Type::INT && prog_.constants[c.a].i==v;
+    };
+    auto proven = [&](NodeId id){ return facts_[id].type==StaticType::Int; };
+    switch ((BinOp)n.op){
+        case BinOp::Mul:
+            if (isInt(n.b, 1) && proven(n.a)) return n.a;
+            if (isInt(n.a, 1) && proven(n.b)) return n.b;
+            break;
+        case BinOp::Add:
+            if (isInt(n.b, 0) && proven(n.a)) return n.a;
+            if (isInt(n.a, 0) && proven(n.b)) return n.b;
+            break;
+        case BinOp::Sub:
+            if (isInt(n.b, 0) && proven(n.a)) return n.a;
+            break;
+        default:
+            break;
+    }
+    return NO_NODE;
+}
+
+// Names and constants can be read by a superinstruction in place.
+bool Compiler::operand(NodeId id, uint32_t& ref){
+    const Node& n = prog_[id];
+    uint32_t index;
+    if (n.kind==NodeKind::Const){
+        index = n.a;
+        ref = Operand::CONST;
+    }else if (n.kind==NodeKind::Name){
+        auto it = slots_.find(n.a);
+        index = it!=slots_.end() ? it->second : n.a;
+        ref = it!=slots_.end() ? Operand::LOCAL : Operand::GLOBAL;
+    }else{
+        return false;
+    }
+    if (index & Operand::KIND) return false;
+    ref |= index;
+    return true;
+}
+
+Spec Compiler::spec(const Fact& lhs, const Fact& rhs, const Fact* result) const{
+    if (lhs.type!=StaticType::Int || rhs.type!=StaticType::Int) return Spec::Generic;
+    bool small = lhs.range.bounded() && rhs.range.bounded() && (!result || result->range.bounded());
+    return small ? Spec::Small : Spec::Int;
+}
+
+// Emits the test of an if/while and a jump taken when it fails; returns the
+// jump to patch. A simple comparison becomes one CompareJump.
+size_t Compiler::branchIfFalse(NodeId cond){
+    const Node& n = prog_[cond];
+    uint32_t lhs, rhs;
+    if (n.kind==NodeKind::Compare && n.count==3 && operand(prog_.child(n, 2), rhs)){
+        NodeId left = prog_.child(n, 0);
+        if (!operand(left, lhs)){
+            expr(left);
+            lhs = Operand::TOP;
+        }
+        Spec sp = spec(facts_[left], facts_[prog_.child(n, 2)], nullptr);
+        return emit(Op::CompareJump, 0, lhs, (uint8_t)prog_.child(n, 1), rhs, sp);
+    }
+    expr(cond);
+    return emit(Op::JumpIfFalse);
+}
+
+void Compiler::call(const Node& n, bool tail){
+    if (n.b!=NO_NODE){
+        expr(n.b);
+        emit(Op::Pop);
+    }
+    CallSite site;
+    site.callee = n.a;
+    for (uint32_t i = 0; i < n.count; ++i){
+        const Node& arg = prog_[prog_.child(n, i)];
+        if (arg.kind==NodeKind::Keyword){
+            expr(arg.b);
+            site.names.push_back(arg.a==NO_NODE ? CallSite::UNNAMED_KEYWORD : arg.a);
+        }else{
+            expr(prog_.child(n, i));
+            site.names.push_back(CallSite::POSITIONAL);
+        }
+    }
+    mod_.calls.push_back(std::move(site));
+    emit(Op::Call, (uint32_t)mod_.calls.size() - 1, 0, tail ? 1 : 0);
+}
@@ -0,0 +1,64 @@
+#pragma once
+#ifndef PYTHON_INTERPRETER_COMPILER_H
+#define PYTHON_INTERPRETER_COMPILER_H
+
+#include "Bytecode.h"
+#include "TypeInference.h"
+
+// Translates an (optimized) Program into VM bytecode. Each def body becomes
+// its own CodeUnit; names a function assigns become numbered local slots that
+// reproduce the interpreter's scoping (a slot only binds while the name is
+// not a global, and unbound slots read through to the global). Operators
+// whose operand types TypeInference proves get type-specialized opcodes, and
+// int operations whose operands and result provably fit an int64 get the
+// *Small forms, and x * 1, x + 0 and the like drop the no-op when x is an
+// int. Hot statement shapes whose inputs are names or constants compile to
+// superinstructions (see Op::BinaryOperands and below).
+class Compiler {
+public:
+    // constants the compiler needs are appended to program
+    explicit Compiler(Program& program) : prog_(program) {}
+
+    Module compile();
+
+private:
+    struct Loop {
+        uint32_t top;
+        std::vector<size_t> breaks;
+    };
+
+    Program& prog_;
+    Module mod_;
+    uint32_t unit_ = 0;
+    uint32_t line_ = 0;
+    std::unordered_map<uint32_t, uint32_t> slots_; // symbol -> slot in the unit being compiled
+    std::vector<Loop> loops_;
+    std::vector<std::pair<uint32_t, NodeId>> pending_; // def units still to compile
+    uint32_t none_ = NO_NODE;
+    std::vector<Fact> facts_; // per node, from TypeInference
+
+    CodeUnit& unit() { return mod_.units[unit_]; }
+    uint32_t here() { return (uint32_t)unit().code.size(); }
+    size_t emit(Op op, uint32_t a = 0, uint32_t b = 0, uint8_t aux = 0, uint32_t c = 0, Spec spec = Spec::Generic);
+    void patch(size_t at) { unit().code[at].a = here(); }
+    uint32_t constant(Value v) { return prog_.addConstant(std::move(v)); }
+
+    void compileFunction(uint32_t index, NodeId def);
+    void collectSlots(NodeId id);
+    uint32_t slotFor(uint32_t sym);
+
+    void stmt(NodeId id);
+    void assign(const Node& n);
+    void expr(NodeId id, bool tail = false);
+    void call(const Node& n, bool tail);
+    void binary(BinOp op, uint32_t k, const Fact& lhs, const Fact& rhs, const Fact& result, bool swapped);
+    NodeId identityOperand(const Node& n) const;
+    bool operand(NodeId id, uint32_t& ref);
+    Spec spec(const Fact& lhs, const Fact& rhs, const Fact* result) const;
+    size_t branchIfFalse(NodeId cond);
+    void load(uint32_t sym);
+    void store(uint32_t sym);
+    void fail(const char* message);
+};
+
+#endif // PYTHON_INTERPRETER_COMPILER_H
@@ -0,0 +1,31 @@
+#include "Frontend.h"
+#include "LoweringVisitor.h"
+#include "NativeLexer.h"
+#include "NativeParser.h"
+#include "NativeTokenSource.h"
+#include "Optimizer.h"
+#include "Python3Parser.h"
+#include "antlr4-runtime.h"
+using namespace antlr4;
+using namespace std;
+
+// Reference front end: ANTLR parse tree lowered into the arena AST.
+static Program parseAntlr(const TokenBuffer& buffer){
+    NativeTokenSource lexer(buffer);
+    CommonTokenStream tokens(&lexer);
+    tokens.fill();
+    Python3Parser parser(&tokens);
+    Python3Parser::File_inputContext* tree = parser.file_input();
+    if (parser.getNumberOfSyntaxErrors() > 0){
+        throw SyntaxError((uint32_t)tree->getStart()->getLine(), "invalid syntax");
+    }
+    return LoweringVisitor().lower(tree);
+}
+
+Program parseSource(string_view text, bool use_antlr){
+    // the lexer reads the bytes in place
+    TokenBuffer buffer = NativeLexer(text).run();
+    Program program = use_antlr ? parseAntlr(buffer) : NativeParser(buffer).parse();
+    Optimizer(program).run();
+    return program;
+}
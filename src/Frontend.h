@@ -0,0 +1,15 @@
+#pragma once
+#ifndef PYTHON_INTERPRETER_FRONTEND_H
+#define PYTHON_INTERPRETER_FRONTEND_H
+
+#include "Ast.h"
+#include "NativeParser.h" // SyntaxError
+#include <string_view>
+
+// Script text -> optimized Program, through the native parser or the ANTLR
+// reference parser. Token records, ANTLR tokens, the parser and its tree
+// are released before this returns; only the Program is kept. Throws
+// SyntaxError.
+Program parseSource(std::string_view text, bool use_antlr);
+
+#endif // PYTHON_INTERPRETER_FRONTEND_H
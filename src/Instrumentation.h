@@ -0,0 +1,19 @@
+#pragma once
+#ifndef PYTHON_INTERPRETER_INSTRUMENTATION_H
+#define PYTHON_INTERPRETER_INSTRUMENTATION_H
+
+#include "Budget.h"
+#include "Profiler.h"
+#include "Stats.h"
+#include "Trace.h"
+
+// The optional tools a run reports to or is limited by; null ones are off.
+// Memory accounting is process-wide instead (see Memory).
+struct Instrumentation {
+    Profiler* profiler = nullptr;
+    Stats* stats = nullptr;
+    Trace* trace = nullptr;
+    Budget* budget = nullptr;
+};
+
+#endif // PYTHON_INTERPRETER_INSTRUMENTATION_H
@@ -0,0 +1,450 @@
+#include "Interpreter.h"
+using boost::multiprecision::cpp_int;
+using namespace std;
+
+Interpreter::Interpreter(const Program& program, const Instrumentation& tools)
+    : prog_(program),
+      globals_(program.names.size()),
+      global_bound_(program.names.size(), 0),
+      functions_(program.names.size()),
+      builtins_(program.names.size(), Builtin::None),
+      fn_version_(program.names.size(), 1),
+      call_cache_(program.nodes.size()),
+      profiler_(tools.profiler),
+      stats_(tools.stats),
+      trace_(tools.trace),
+      budget_(tools.budget){
+    for (uint32_t sym = 0; sym < prog_.names.size(); ++sym) builtins_[sym] = builtinOf(prog_.names[sym]);
+}
+
+void Interpreter::run(){
+    if (profiler_) profile_stack_.push_back({NO_NODE, 0});
+    exec(prog_.root);
+    if (Memory::enabled()) checkMemory();
+}
+
+// Environment helpers
+const Value& Interpreter::getVar(uint32_t sym) const{
+    static const Value none;
+    if (!local_param_stack_.empty()){
+        // call frames hold few names, so a linear scan beats hashing
+        for (const auto& slot : local_param_stack_.back()){
+            if (slot.first==sym) return slot.second;
+        }
+    }
+    if (global_bound_[sym]) return globals_[sym];
+    return none;
+}
+void Interpreter::setVar(uint32_t sym, const Value& v){
+    if (!local_param_stack_.empty()){
+        auto& locals = local_param_stack_.back();
+        for (auto& slot : locals){
+            if (slot.first==sym){ slot.second = v; return; }
+        }
+        // names not yet bound globally become locals of the running call
+        if (!global_bound_[sym]){
+            locals.emplace_back(sym, v); return;
+        }
+    }
+    globals_[sym] = v;
+    global_bound_[sym] = 1;
+}
+
+// Statements
+Interpreter::Flow Interpreter::exec(NodeId id){
+    const Node& n = prog_[id];
+    if (profiler_ && n.kind!=NodeKind::Block){
+        profile_stack_.back().line = n.line;
+        if (Profiler::due()) profiler_->sample(profile_stack_.data(), profile_stack_.size());
+    }
+    if (stats_ && n.kind!=NodeKind::Block) stats_->line(n.line);
+    if (Memory::due()) checkMemory();
+    switch (n.kind){
+        case NodeKind::Block: return execBlock(n);
+        case NodeKind::ExprStmt: eval(n.a); return Flow::Normal;
+        case NodeKind::Assign: execAssign(n); return Flow::Normal;
+        case NodeKind::AugAssign: {
+            const Node& target = prog_[n.a];
+            if (target.kind!=NodeKind::Name) throw runtime_error("invalid augmented assignment target");
+            Value rv = eval(n.b);
+            if (stats_) stats_->binary((BinOp)n.op, getVar(target.a), rv);
+            setVar(target.a, binary((BinOp)n.op, getVar(target.a), rv, n.first));
+            return Flow::Normal;
+        }
+        case NodeKind::If: {
+            for (uint32_t i = 0; i + 1 < n.count; i += 2){
+                if (isTruthy(eval(prog_.child(n, i)))) return exec(prog_.child(n, i + 1));
+            }
+            if (n.b!=NO_NODE) return exec(n.b);
+            return Flow::Normal;
+        }
+        case NodeKind::While: {
+            while (isTruthy(eval(n.a))){
+                Flow f = exec(n.b);
+                // the condition runs next
+                if (profiler_) profile_stack_.back().line = n.line;
+                if (stats_) stats_->line(n.line);
+                if (f==Flow::Break) break;
+                if (f==Flow::Return || f==Flow::TailCall) return f;
+                if (budget_) budget_->step(); // the back-edge
+            }
+            return Flow::Normal;
+        }
+        case NodeKind::Break: return Flow::Break;
+        case NodeKind::Continue: return Flow::Continue;
+        case NodeKind::Return:
+            if (n.a!=NO_NODE && isSelfTailCall(n.a)){
+                // evaluated into a buffer taken from tail_args_, which an
+                // argument's own tail call may fill while we are still going
+                vector<Arg> args;
+                args.swap(tail_args_);
+                evalArgs(prog_[n.a], args);
+                tail_args_.swap(args);
+                return Flow::TailCall;
+            }
+            return_value_ = n.a==NO_NODE ? Value::None() : eval(n.a);
+            return Flow::Return;
+        case NodeKind::FuncDef: defineFunction(n); return Flow::Normal;
+        default:
+            throw runtime_error("not a statement");
+    }
+}
+
+Interpreter::Flow Interpreter::execBlock(const Node& n){
+    for (uint32_t i = 0; i < n.count; ++i){
+        Flow f = exec(prog_.child(n, i));
+        if (f!=Flow::Normal) return f;
+    }
+    return Flow::Normal;
+}
+
+// a = b = ... = value; tuple targets unpack element-wise
+void Interpreter::execAssign(const Node& n){
+    vector<Value> values = evalList(prog_.child(n, n.count - 1));
+    for (uint32_t i = 0; i + 1 < n.count; ++i) assign(prog_.child(n, i), values);
+}
+
+void Interpreter::assign(NodeId target, vector<Value>& values){
+    const Node& t = prog_[target];
+    if (t.kind==NodeKind::Name){
+        setVar(t.a, values.empty() ? Value::None() : values.back());
+        return;
+    }
+    if (t.kind==NodeKind::Tuple && t.count==values.size()){
+        for (uint32_t i = 0; i < t.count; ++i){
+            const Node& e = prog_[prog_.child(t, i)];
+            if (e.kind!=NodeKind::Name) throw runtime_error("invalid assignment target");
+            setVar(e.a, values[i]);
+        }
+        return;
+    }
+    throw runtime_error("invalid assignment target");
+}
+
+void Interpreter::defineFunction(const Node& n){
+    Function fn;
+    for (uint32_t i = 0; i < n.count; ++i){
+        const Node& p = prog_[prog_.child(n, i)];
+        fn.params.push_back(p.a);
+        if (p.b==NO_NODE) fn.required_count = i + 1;
+    }
+    // defaults: aligned at end
+    for (size_t i = fn.required_count; i < n.count; ++i){
+        const Node& p = prog_[prog_.child(n, (uint32_t)i)];
+        fn.defaults.push_back(p.b==NO_NODE ? Value::None() : eval(p.b));
+    }
+    fn.body = n.b;
+    fn.name = n.a;
+    functions_[n.a] = std::move(fn);
+    ++fn_version_[n.a]; // drops every call site cached against the old def
+}
+
+// Expressions
+Value Interpreter::unary(UnaryOp op, const Value& v){
+    if (op==UnaryOp::Pos){
+        if (v.type==Value::Type::INT || v.type==Value::Type::BOOL || v.type==Value::Type::FLOAT) return v;
+        return Value::None();
+    }
+    if (v.type==Value::Type::FLOAT) return Value::fromFloat(-v.f);
+    if (v.type==Value::Type::INT) return Value::fromInt(-v.i);
+    if (v.type==Value::Type::BOOL) return Value::fromInt(v.b? -1: 0);
+    return Value::None();
+}
+
+Value Interpreter::binary(BinOp op, const Value& a, const Value& b){
+    switch (op){
+        case BinOp::Add: return add(a, b);
+        case BinOp::Sub: return sub(a, b);
+        case BinOp::Mul: return mul(a, b);
+        case BinOp::Div: return truediv(a, b);
+        case BinOp::FloorDiv: case BinOp::FloorDivPow2: return floordiv(a, b);
+        case BinOp::Mod: case BinOp::ModPow2: return mod(a, b);
+    }
+    return Value::None();
+}
+
+// Shift/mask forms of // and % by 2**k; floor semantics hold for negative
+// ints because cpp_int shifts arithmetically and masks in two's complement.
+// Any other op is passed through to binary().
+Value Interpreter::binary(BinOp op, const Value& a, const Value& divisor, uint32_t k){
+    if (op!=BinOp::FloorDivPow2 && op!=BinOp::ModPow2) return binary(op, a, divisor);
+    if (a.type==Value::Type::INT){
+        if (op==BinOp::FloorDivPow2) return Value::fromInt(a.i >> k);
+        return Value::fromInt(a.i & cpp_int((1ull << k) - 1));
+    }
+    if (a.type==Value::Type::BOOL){
+        int x = a.b ? 1 : 0;
+        if (op==BinOp::FloorDivPow2) return Value::fromInt(k==0 ? x : 0);
+        return Value::fromInt(k==0 ? 0 : x);
+    }
+    return binary(op, a, divisor);
+}
+
+vector<Value> Interpreter::evalList(NodeId id){
+    const Node& n = prog_[id];
+    vector<Value> res;
+    if (n.kind!=NodeKind::Tuple){ res.push_back(eval(id)); return res; }
+    res.reserve(n.count);
+    for (uint32_t i = 0; i < n.count; ++i) res.push_back(eval(prog_.child(n, i)));
+    return res;
+}
+
+Value Interpreter::eval(NodeId id){
+    const Node& n = prog_[id];
+    switch (n.kind){
+        case NodeKind::Const: return prog_.constants[n.a];
+        case NodeKind::Name: return getVar(n.a);
+        case NodeKind::FString: {
+            string out;
+            for (uint32_t i = 0; i < n.count; ++i) out += toString(eval(prog_.child(n, i)));
+            return Value::fromStr(std::move(out));
+        }
+        case NodeKind::Tuple: {
+            // a bare testlist evaluates every element and yields the last one
+            Value v;
+            for (uint32_t i = 0; i < n.count; ++i) v = eval(prog_.child(n, i));
+            return v;
+        }
+        case NodeKind::Unary: return unary((UnaryOp)n.op, eval(n.a));
+        case NodeKind::Not: return Value::fromBool(!isTruthy(eval(n.a)));
+        case NodeKind::Binary: {
+            Value lhs = eval(n.a);
+            Value rhs = eval(n.b);
+            if (stats_) stats_->binary((BinOp)n.op, lhs, rhs);
+            return binary((BinOp)n.op, lhs, rhs, n.first);
+        }
+        case NodeKind::Or: {
+            // short-circuit; yields the deciding operand like Python
+            Value v;
+            for (uint32_t i = 0; i < n.count; ++i){
+                v = eval(prog_.child(n, i));
+                if (isTruthy(v)) return v;
+            }
+            return v;
+        }
+        case NodeKind::And: {
+            Value v;
+            for (uint32_t i = 0; i < n.count; ++i){
+                v = eval(prog_.child(n, i));
+                if (!isTruthy(v)) return v;
+            }
+            return v;
+        }
+        case NodeKind::Compare: return evalCompare(n);
+        case NodeKind::Call: return evalCall(id, n);
+        default:
+            throw runtime_error("not an expression");
+    }
+}
+
+Value Interpreter::evalCompare(const Node& n){
+    Value lhs = eval(prog_.child(n, 0));
+    for (uint32_t i = 1; i + 1 < n.count; i += 2){
+        CmpOp op = (CmpOp)prog_.child(n, i);
+        Value rhs = eval(prog_.child(n, i + 1));
+        if (!compare(op, lhs, rhs)) return Value::fromBool(false);
+        lhs = std::move(rhs);
+    }
+    return Value::fromBool(true);
+}
+
+// incomparable operands are unequal and unordered
+bool Interpreter::compare(CmpOp op, const Value& lhs, const Value& rhs){
+    int c;
+    try{ c = cmp(lhs, rhs); }
+    catch(...){ c = INT_MIN; }
+    switch (op){
+        case CmpOp::Eq: return c==0;
+        case CmpOp::Ne: return c!=0;
+        case CmpOp::Lt: return c!=INT_MIN && c<0;
+        case CmpOp::Gt: return c!=INT_MIN && c>0;
+        case CmpOp::Le: return c!=INT_MIN && c<=0;
+        case CmpOp::Ge: return c!=INT_MIN && c>=0;
+    }
+    return false;
+}
+
+Value Interpreter::evalCall(NodeId id, const Node& n){
+    if (n.b!=NO_NODE) eval(n.b);
+    vector<Arg> args;
+    evalArgs(n, args);
+    // a call through anything but a NAME is not supported and yields None
+    if (n.a==NO_NODE) return Value::None();
+    CallCache& ic = call_cache_[id];
+    if (ic.version!=fn_version_[n.a]) resolveCall(ic, n.a);
+    if (ic.builtin!=Builtin::None){
+        if (trace_) traceEnter(n.a, true, args);
+        vector<Value> values;
+        values.reserve(args.size());
+        for (auto& arg : args) values.push_back(std::move(arg.value));
+        Value r = callBuiltin(ic.builtin, values.data(), values.size());
+        if (trace_) trace_->leave();
+        return r;
+    }
+    if (ic.fn) return callUserFunction(*ic.fn, args);
+    // unknown callable -> None
+    return Value::None();
+}
+
+void Interpreter::evalArgs(const Node& n, vector<Arg>& args){
+    args.clear();
+    args.reserve(n.count);
+    for (uint32_t i = 0; i < n.count; ++i){
+        const Node& arg = prog_[prog_.child(n, i)];
+        if (arg.kind==NodeKind::Keyword){
+            Value val = eval(arg.b);
+            args.push_back({arg.a==NO_NODE ? UNNAMED_KEYWORD : arg.a, std::move(val)});
+        }else{
+            args.push_back({POSITIONAL, eval(prog_.child(n, i))});
+        }
+    }
+}
+
+// True if returning the call at id would just re-enter the running function.
+bool Interpreter::isSelfTailCall(NodeId id){
+    const Node& n = prog_[id];
+    if (!current_fn_ || n.kind!=NodeKind::Call || n.a==NO_NODE) return false;
+    CallCache& ic = call_cache_[id];
+    if (ic.version!=fn_version_[n.a]) resolveCall(ic, n.a);
+    return ic.fn==current_fn_;
+}
+
+// Builtins and function calls
+void Interpreter::resolveCall(CallCache& ic, uint32_t sym){
+    // builtins shadow user definitions of the same name
+    ic.builtin = builtins_[sym];
+    ic.fn = ic.builtin==Builtin::None && functions_[sym].body!=NO_NODE ? &functions_[sym] : nullptr;
+    ic.version = fn_version_[sym];
+}
+
+// Binds call arguments to fn's parameters in locals; false if they don't fit.
+bool Interpreter::bindArguments(const Function& fn, vector<Arg>& args, Locals& locals){
+    size_t n = fn.params.size();
+    // scratch buffers are members so that tail calls bind without allocating
+    vector<Value>& actual = bind_values_;
+    vector<char>& assigned = bind_assigned_;
+    actual.assign(n, Value::None());
+    assigned.assign(n, 0);
+    size_t posi = 0;
+    // positional first
+    for (auto& arg : args){
+        if (arg.name==POSITIONAL){
+            if (posi>=n) return false;
+            actual[posi] = std::move(arg.value); assigned[posi]=1; posi++;
+        }
+    }
+    // keywords
+    for (auto& arg : args){
+        if (arg.name!=POSITIONAL){
+            size_t idx = 0;
+            while (idx<n && fn.params[idx]!=arg.name) ++idx;
+            if (idx==n) return false;
+            actual[idx] = std::move(arg.value); assigned[idx]=1;
+        }
+    }
+    // fill defaults
+    for (size_t i=0;i<n;++i){
+        if (!assigned[i]){
+            if (i < fn.required_count) return false;
+            size_t j = i - fn.required_count; if (j<fn.defaults.size()) actual[i] = fn.defaults[j];
+        }
+    }
+    // build local param scope
+    locals.clear();
+    for (size_t i=0;i<n;++i){
+        // a repeated parameter name binds the last value, as the map used to
+        auto dup = find_if(locals.begin(), locals.end(), [&](const auto& s){ return s.first==fn.params[i]; });
+        if (dup!=locals.end()) dup->second = std::move(actual[i]);
+        else locals.emplace_back(fn.params[i], std::move(actual[i]));
+    }
+    return true;
+}
+
+// Memory checkpoint over everything a variable can reach.
+void Interpreter::checkMemory() const{
+    Memory::Usage usage;
+    size_t& env = usage.bytes[Memory::ENVIRONMENT];
+    env += globals_.capacity() * sizeof(Value) + global_bound_.capacity() + functions_.capacity() * sizeof(Function);
+    for (const Value& v : globals_) Memory::addValue(usage, v);
+    for (const Function& fn : functions_){
+        env += fn.params.capacity() * sizeof(uint32_t) + fn.defaults.capacity() * sizeof(Value);
+        for (const Value& v : fn.defaults) Memory::addValue(usage, v);
+    }
+    env += local_param_stack_.capacity() * sizeof(Locals);
+    for (const Locals& locals : local_param_stack_){
+        env += locals.capacity() * sizeof(Locals::value_type);
+        for (const auto& slot : locals) Memory::addValue(usage, slot.second);
+    }
+    Memory::addValue(usage, return_value_);
+    Memory::addProgram(usage, prog_);
+    Memory::checkpoint(usage);
+}
+
+void Interpreter::traceEnter(uint32_t callee, bool builtin, const vector<Arg>& args){
+    uint64_t bytes = 0;
+    for (const Arg& arg : args) bytes += Trace::payloadBytes(arg.value);
+    trace_->enter(callee, builtin, args.size(), bytes);
+}
+
+Value Interpreter::callUserFunction(const Function& fn, vector<Arg>& args){
+    if (budget_) budget_->step();
+    if (trace_) traceEnter(fn.name, false, args);
+    Locals locals;
+    if (!bindArguments(fn, args, locals)){
+        if (trace_) trace_->leave();
+        return Value::None();
+    }
+    local_param_stack_.push_back(std::move(locals));
+    const Function* caller = current_fn_;
+    current_fn_ = &fn;
+    if (profiler_) profile_stack_.push_back({fn.name, prog_[fn.body].line});
+    if (stats_) stats_->enter(fn.name);
+    Flow f;
+    for (;;){
+        NodeId body = fn.body; // fn may be replaced by a nested def while running
+        f = exec(body);
+        if (f!=Flow::TailCall) break;
+        // return fn(...) in tail position: rebind this frame and run the body again
+        args.swap(tail_args_);
+        if (budget_) budget_->step();
+        if (stats_){
+            stats_->leave();
+            stats_->enter(fn.name);
+        }
+        if (trace_){
+            trace_->leave();
+            traceEnter(fn.name, false, args);
+        }
+        if (!bindArguments(fn, args, local_param_stack_.back())){
+            f = Flow::Normal;
+            break;
+        }
+    }
+    current_fn_ = caller;
+    if (profiler_) profile_stack_.pop_back();
+    if (stats_) stats_->leave();
+    if (trace_) trace_->leave();
+    local_param_stack_.pop_back();
+    if (f==Flow::Return) return std::move(return_value_);
+    return Value::None();
+}
@@ -0,0 +1,105 @@
+#pragma once
+#ifndef PYTHON_INTERPRETER_INTERPRETER_H
+#define PYTHON_INTERPRETER_INTERPRETER_H
+
+#include "Ast.h"
+#include "Builtins.h"
+#include "Instrumentation.h"
+#include "Memory.h"
+
+struct Function {
+    std::vector<uint32_t> params; // parameter symbol ids
+    size_t required_count = 0;    // number of params without defaults (prefix)
+    std::vector<Value> defaults;  // defaults for trailing params (size = params.size() - required_count)
+    NodeId body = NO_NODE;        // function body (a Block)
+    uint32_t name = NO_NODE;      // def symbol
+};
+
+// Tree-walking evaluator over the arena AST produced by NativeParser.
+// Variables and functions are addressed by symbol id; no name strings are
+// built or hashed while the program runs.
+class Interpreter {
+public:
+    // the profiler, stats and trace in tools observe the run, its budget limits it
+    explicit Interpreter(const Program& program, const Instrumentation& tools = {});
+
+    void run();
+
+    // operator semantics, shared with the optimizer (so folding is exact) and the VM
+    static Value unary(UnaryOp op, const Value& v);
+    static Value binary(BinOp op, const Value& a, const Value& b);
+    static Value binary(BinOp op, const Value& a, const Value& divisor, uint32_t k);
+    static bool compare(CmpOp op, const Value& a, const Value& b);
+
+private:
+    // TailCall: a self-recursive `return f(...)` left its arguments in tail_args_
+    enum class Flow { Normal, Break, Continue, Return, TailCall };
+
+    // call argument; name is a symbol id, POSITIONAL or UNNAMED_KEYWORD
+    struct Arg {
+        uint32_t name;
+        Value value;
+    };
+    static constexpr uint32_t POSITIONAL = NO_NODE;
+    static constexpr uint32_t UNNAMED_KEYWORD = NO_NODE - 1;
+
+    using Locals = std::vector<std::pair<uint32_t, Value>>;
+
+    // per call site: the resolved target, valid while version matches the
+    // callee symbol's definition count
+    struct CallCache {
+        uint32_t version = 0; // 0 = never resolved
+        Builtin builtin = Builtin::None;
+        const Function* fn = nullptr;
+    };
+
+    const Program& prog_;
+
+    // environments, indexed by symbol id
+    std::vector<Value> globals_;
+    std::vector<char> global_bound_;
+    std::vector<Function> functions_; // body == NO_NODE while undefined
+    std::vector<Builtin> builtins_;
+    std::vector<uint32_t> fn_version_; // bumped by every def of the symbol
+    std::vector<CallCache> call_cache_; // indexed by Call node id
+    // current function call scope: parameters and names first bound inside the call
+    std::vector<Locals> local_param_stack_;
+    Value return_value_;
+    const Function* current_fn_ = nullptr; // innermost running user function
+    std::vector<Arg> tail_args_;
+    std::vector<Value> bind_values_;
+    std::vector<char> bind_assigned_;
+    Profiler* profiler_;
+    std::vector<Profiler::Frame> profile_stack_; // kept only while profiling
+    Stats* stats_;
+    Trace* trace_;
+    Budget* budget_;
+
+    // statements
+    Flow exec(NodeId id);
+    Flow execBlock(const Node& n);
+    void execAssign(const Node& n);
+    void assign(NodeId target, std::vector<Value>& values);
+    void defineFunction(const Node& n);
+
+    // expressions
+    Value eval(NodeId id);
+    std::vector<Value> evalList(NodeId id);
+    Value evalCompare(const Node& n);
+    Value evalCall(NodeId id, const Node& n);
+    void evalArgs(const Node& n, std::vector<Arg>& args);
+    bool isSelfTailCall(NodeId id);
+
+    // name resolution and assignment
+    const Value& getVar(uint32_t sym) const;
+    void setVar(uint32_t sym, const Value& v);
+
+    // builtins and calls
+    void resolveCall(CallCache& ic, uint32_t sym);
+    bool bindArguments(const Function& fn, std::vector<Arg>& args, Locals& locals);
+    Value callUserFunction(const Function& fn, std::vector<Arg>& args);
+    void traceEnter(uint32_t callee, bool builtin, const std::vector<Arg>& args);
+    void checkMemory() const;
+};
+
+#endif // PYTHON_INTERPRETER_INTERPRETER_H
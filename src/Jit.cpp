@@ -0,0 +1,391 @@
+#include "Jit.h"
+#if defined(__x86_64__) && defined(__linux__)
+#define JIT_X86_64 1
+#include <sys/mman.h>
+#else
+#define JIT_X86_64 0
+#endif
+using namespace std;
+
+NativeLoop::~NativeLoop(){
+#if JIT_X86_64
+    if (mem_) munmap(mem_, size_);
+#endif
+}
+
+bool LoopJit::available(){ return JIT_X86_64; }
+
+#if !JIT_X86_64
+
+unique_ptr<NativeLoop> LoopJit::compile(const Program&, const vector<Instr>&, uint32_t, uint32_t, bool){
+    return nullptr;
+}
+
+#else
+
+namespace {
+
+// Stencils. rbx holds the register file for the whole loop; rax and rcx are
+// the working registers. A trailing hole is a disp32 off rbx, an imm32/64
+// or a rel32 jump distance, patched in after the copy.
+const uint8_t PROLOGUE[] = {0x53, 0x48, 0x89, 0xFB};              // push rbx; mov rbx, rdi
+const uint8_t EPILOGUE[] = {0x5B, 0xC3};                          // pop rbx; ret
+const uint8_t LOAD_RAX[] = {0x48, 0x8B, 0x83, 0, 0, 0, 0};        // mov rax, [rbx + d32]
+const uint8_t LOAD_RCX[] = {0x48, 0x8B, 0x8B, 0, 0, 0, 0};        // mov rcx, [rbx + d32]
+const uint8_t STORE_RAX[] = {0x48, 0x89, 0x83, 0, 0, 0, 0};       // mov [rbx + d32], rax
+const uint8_t IMM_RAX[] = {0x48, 0xB8, 0, 0, 0, 0, 0, 0, 0, 0};   // mov rax, i64
+const uint8_t IMM_RCX[] = {0x48, 0xB9, 0, 0, 0, 0, 0, 0, 0, 0};   // mov rcx, i64
+const uint8_t ADD[] = {0x48, 0x01, 0xC8};                         // add rax, rcx
+const uint8_t SUB[] = {0x48, 0x29, 0xC8};                         // sub rax, rcx
+const uint8_t IMUL[] = {0x48, 0x0F, 0xAF, 0xC1};                  // imul rax, rcx
+const uint8_t AND[] = {0x48, 0x21, 0xC8};                         // and rax, rcx
+const uint8_t NEG[] = {0x48, 0xF7, 0xD8};                         // neg rax
+const uint8_t SAR[] = {0x48, 0xC1, 0xF8, 0};                      // sar rax, i8
+const uint8_t CMP[] = {0x48, 0x39, 0xC8};                         // cmp rax, rcx
+const uint8_t TEST[] = {0x48, 0x85, 0xC0};                        // test rax, rax
+const uint8_t JMP[] = {0xE9, 0, 0, 0, 0};                         // jmp rel32
+const uint8_t JCC[] = {0x0F, 0x80, 0, 0, 0, 0};                   // j<cc> rel32; cc patched into byte 1
+const uint8_t EXIT[] = {0xB8, 0, 0, 0, 0};                        // mov eax, i32
+const uint8_t SUB_ONE[] = {0x48, 0x83, 0xAB, 0, 0, 0, 0, 0x01};   // sub qword [rbx + d32], 1
+// helper(rax, rcx, &scratch) -> al; result in scratch
+const uint8_t CALL_HELPER[] = {
+    0x48, 0x89, 0xC7,                   // mov rdi, rax
+    0x48, 0x89, 0xCE,                   // mov rsi, rcx
+    0x48, 0x8D, 0x93, 0, 0, 0, 0,       // lea rdx, [rbx + d32]
+    0x48, 0xB8, 0, 0, 0, 0, 0, 0, 0, 0, // mov rax, helper
+    0xFF, 0xD0,                         // call rax
+    0x84, 0xC0,                         // test al, al
+};
+constexpr size_t CALL_HELPER_SCRATCH = 9;
+constexpr size_t CALL_HELPER_TARGET = 15;
+
+// condition codes, for the low nibble of JCC's second byte
+enum Cond : uint8_t { O = 0x0, E = 0x4, NE = 0x5, S = 0x8, L = 0xC, GE = 0xD, LE = 0xE, G = 0xF };
+
+bool floorDivHelper(int64_t a, int64_t b, int64_t* out){ return floor_div_small(a, b, *out); }
+bool modHelper(int64_t a, int64_t b, int64_t* out){ return mod_small(a, b, *out); }
+
+class LoopCompiler {
+public:
+    LoopCompiler(const Program& program, const vector<Instr>& code, uint32_t top, uint32_t end, bool metered,
+                 NativeLoop& loop)
+        : prog_(program), code_(code), top_(top), end_(end), metered_(metered), loop_(loop),
+          labels_(end - top + 1, NONE) {}
+
+    bool compile();
+    vector<uint8_t>& bytes() { return out_; }
+
+private:
+    static constexpr size_t NONE = SIZE_MAX;
+    struct Fixup {
+        size_t at;       // rel32 hole
+        bool exit;       // target is exit stub index, else a bytecode pc
+        uint32_t target;
+    };
+
+    const Program& prog_;
+    const vector<Instr>& code_;
+    uint32_t top_, end_;
+    bool metered_;
+    NativeLoop& loop_;
+    vector<uint8_t> out_;
+    vector<size_t> labels_; // code offset of each bytecode pc in the loop
+    vector<Fixup> fixups_;
+    map<pair<uint32_t, uint32_t>, uint32_t> exit_index_;
+    uint32_t depth_ = 0;
+
+    template <size_t N> void copy(const uint8_t (&stencil)[N]) { out_.insert(out_.end(), stencil, stencil + N); }
+    void patch(size_t at, const void* value, size_t size) { memcpy(out_.data() + at, value, size); }
+    template <size_t N> void copy32(const uint8_t (&stencil)[N], int32_t v){ copy(stencil); patch(out_.size() - 4, &v, 4); }
+    template <size_t N> void copy64(const uint8_t (&stencil)[N], int64_t v){ copy(stencil); patch(out_.size() - 8, &v, 8); }
+
+    static int32_t varAt(uint32_t i) { return (int32_t)(8 * i); }
+    static int32_t tempAt(uint32_t i) { return (int32_t)(8 * (NativeLoop::MAX_VARS + i)); }
+    static int32_t fuelAt() { return (int32_t)(8 * NativeLoop::FUEL); }
+    static int32_t scratchAt() { return (int32_t)(8 * (NativeLoop::REGS - 1)); }
+
+    bool var(bool global, uint32_t index, int32_t& disp);
+    bool smallConstant(uint32_t index, int64_t& v) const;
+    bool load(uint32_t ref, bool rcx);
+    bool arith(BinOp op, uint32_t k, uint32_t pc);
+    void jumpIf(Cond cc, bool exit, uint32_t target);
+    void jump(uint32_t target);
+    void spendFuel(uint32_t target);
+    uint32_t exitAt(uint32_t pc, uint32_t depth);
+    bool instr(uint32_t& pc);
+};
+
+bool LoopCompiler::var(bool global, uint32_t index, int32_t& disp){
+    for (uint32_t i = 0; i < loop_.vars.size(); ++i){
+        if (loop_.vars[i].global==global && loop_.vars[i].index==index){
+            disp = varAt(i);
+            return true;
+        }
+    }
+    if (loop_.vars.size()==NativeLoop::MAX_VARS) return false;
+    loop_.vars.push_back({global, index});
+    disp = varAt((uint32_t)loop_.vars.size() - 1);
+    return true;
+}
+
+bool LoopCompiler::smallConstant(uint32_t index, int64_t& v) const{
+    const Value& c = prog_.constants[index];
+    if (c.type!=Value::Type::INT || c.i < INT64_MIN || c.i > INT64_MAX) return false;
+    v = c.i.convert_to<int64_t>();
+    return true;
+}
+
+// rax (or rcx) = operand
+bool LoopCompiler::load(uint32_t ref, bool rcx){
+    uint32_t index = ref & ~Operand::KIND;
+    int32_t disp;
+    int64_t v;
+    switch (ref & Operand::KIND){
+        case Operand::CONST:
+            if (!smallConstant(index, v)) return false;
+            if (rcx) copy64(IMM_RCX, v); else copy64(IMM_RAX, v);
+            return true;
+        case Operand::LOCAL: case Operand::GLOBAL:
+            if (!var((ref & Operand::KIND)==Operand::GLOBAL, index, disp)) return false;
+            if (rcx) copy32(LOAD_RCX, disp); else copy32(LOAD_RAX, disp);
+            return true;
+        default:
+            return false;
+    }
+}
+
+uint32_t LoopCompiler::exitAt(uint32_t pc, uint32_t depth){
+    auto it = exit_index_.find({pc, depth});
+    if (it!=exit_index_.end()) return it->second;
+    uint32_t index = (uint32_t)loop_.exits.size();
+    loop_.exits.push_back({pc, depth});
+    exit_index_.emplace(make_pair(pc, depth), index);
+    return index;
+}
+
+void LoopCompiler::jumpIf(Cond cc, bool exit, uint32_t target){
+    copy(JCC);
+    out_[out_.size() - 5] = (uint8_t)(0x80 | cc);
+    fixups_.push_back({out_.size() - 4, exit, target});
+}
+
+// targets outside the loop leave it
+void LoopCompiler::jump(uint32_t target){
+    copy(JMP);
+    if (target >= top_ && target <= end_) fixups_.push_back({out_.size() - 4, false, target});
+    else fixups_.push_back({out_.size() - 4, true, exitAt(target, 0)});
+}
+
+// one step for a backward jump to target; with none left the jump is still
+// taken, by leaving for target with the fuel at -1
+void LoopCompiler::spendFuel(uint32_t target){
+    copy(SUB_ONE);
+    int32_t disp = fuelAt();
+    patch(out_.size() - 5, &disp, 4);
+    jumpIf(S, true, exitAt(target, 0));
+}
+
+// rax = rax op rcx; leaves through an exit that re-runs pc in the VM
+bool LoopCompiler::arith(BinOp op, uint32_t k, uint32_t pc){
+    uint32_t bail = exitAt(pc, depth_);
+    switch (op){
+        case BinOp::Add: copy(ADD); jumpIf(O, true, bail); return true;
+        case BinOp::Sub: copy(SUB); jumpIf(O, true, bail); return true;
+        case BinOp::Mul: copy(IMUL); jumpIf(O, true, bail); return true;
+        case BinOp::FloorDivPow2:
+            copy(SAR);
+            out_.back() = (uint8_t)k;
+            return true;
+        case BinOp::ModPow2:
+            copy64(IMM_RCX, (int64_t)((1ull << k) - 1));
+            copy(AND);
+            return true;
+        case BinOp::FloorDiv: case BinOp::Mod: {
+            bool (*helper)(int64_t, int64_t, int64_t*) = op==BinOp::FloorDiv ? floorDivHelper : modHelper;
+            size_t at = out_.size();
+            copy(CALL_HELPER);
+            int32_t scratch = scratchAt();
+            uint64_t target = (uint64_t)(uintptr_t)helper;
+            patch(at + CALL_HELPER_SCRATCH, &scratch, 4);
+            patch(at + CALL_HELPER_TARGET, &target, 8);
+            jumpIf(E, true, bail);
+            copy32(LOAD_RAX, scratch);
+            return true;
+        }
+        case BinOp::Div:
+            return false; // true division leaves the ints
+    }
+    return false;
+}
+
+// jump-if-false condition for each comparison
+static Cond failing(CmpOp op){
+    switch (op){
+        case CmpOp::Lt: return GE;
+        case CmpOp::Gt: return LE;
+        case CmpOp::Eq: return NE;
+        case CmpOp::Ge: return L;
+        case CmpOp::Le: return G;
+        case CmpOp::Ne: return E;
+    }
+    return E;
+}
+
+bool LoopCompiler::instr(uint32_t& pc){
+    const Instr& in = code_[pc];
+    int32_t disp;
+    int64_t v;
+    switch (in.op){
+        case Op::Const:
+            if (!smallConstant(in.a, v)){
+                // bool tests like while True: feed straight into the jump
+                const Value& c = prog_.constants[in.a];
+                if (c.type!=Value::Type::BOOL || pc==end_ || code_[pc + 1].op!=Op::JumpIfFalse) return false;
+                v = c.b;
+            }
+            if (depth_==NativeLoop::MAX_TEMPS) return false;
+            copy64(IMM_RAX, v);
+            copy32(STORE_RAX, tempAt(depth_++));
+            return true;
+        case Op::LoadLocal: case Op::LoadGlobal:
+            if (depth_==NativeLoop::MAX_TEMPS || !var(in.op==Op::LoadGlobal, in.a, disp)) return false;
+            copy32(LOAD_RAX, disp);
+            copy32(STORE_RAX, tempAt(depth_++));
+            return true;
+        case Op::StoreLocal: case Op::StoreGlobal:
+            if (!depth_ || !var(in.op==Op::StoreGlobal, in.a, disp)) return false;
+            copy32(LOAD_RAX, tempAt(--depth_));
+            copy32(STORE_RAX, disp);
+            return true;
+        case Op::Pop:
+            if (!depth_) return false;
+            --depth_;
+            return true;
+        case Op::Unary:
+            if (!depth_) return false;
+            if ((UnaryOp)in.aux==UnaryOp::Pos) return true;
+            copy32(LOAD_RAX, tempAt(depth_ - 1));
+            copy(NEG);
+            jumpIf(O, true, exitAt(pc, depth_));
+            copy32(STORE_RAX, tempAt(depth_ - 1));
+            return true;
+        case Op::Binary: case Op::BinaryInt: case Op::BinarySmall: {
+            if (depth_ < 2) return false;
+            uint32_t lhs = in.b ? depth_ - 1 : depth_ - 2;
+            uint32_t rhs = in.b ? depth_ - 2 : depth_ - 1;
+            copy32(LOAD_RAX, tempAt(lhs));
+            copy32(LOAD_RCX, tempAt(rhs));
+            if (!arith((BinOp)in.aux, in.a, pc)) return false;
+            copy32(STORE_RAX, tempAt(depth_ - 2));
+            --depth_;
+            return true;
+        }
+        case Op::BinaryOperands:
+            if (depth_==NativeLoop::MAX_TEMPS || !load(in.b, false) || !load(in.c, true)) return false;
+            if (!arith((BinOp)in.aux, in.a, pc)) return false;
+            copy32(STORE_RAX, tempAt(depth_++));
+            return true;
+        case Op::AugLocal: case Op::AugGlobal:
+            if (!var(in.op==Op::AugGlobal, in.a, disp)) return false;
+            copy32(LOAD_RAX, disp);
+            if (!load(in.c, true) || !arith((BinOp)in.aux, in.b, pc)) return false;
+            copy32(STORE_RAX, disp);
+            return true;
+        case Op::Compare: case Op::CompareInt: case Op::CompareSmall: {
+            // only as the test of an if/while
+            if (depth_ < 2 || pc==end_ || code_[pc + 1].op!=Op::JumpIfFalse || depth_!=2) return false;
+            copy32(LOAD_RAX, tempAt(0));
+            copy32(LOAD_RCX, tempAt(1));
+            copy(CMP);
+            depth_ = 0;
+            ++pc;
+            labels_[pc - top_] = NONE; // nothing may jump between the two
+            uint32_t target = code_[pc].a;
+            if (target >= top_ && target <= end_) jumpIf(failing((CmpOp)in.aux), false, target);
+            else jumpIf(failing((CmpOp)in.aux), true, exitAt(target, 0));
+            return true;
+        }
+        case Op::CompareJump:
+            if (in.b==Operand::TOP){
+                if (depth_!=1) return false;
+                copy32(LOAD_RAX, tempAt(--depth_));
+            }else if (depth_ || !load(in.b, false)){
+                return false;
+            }
+            if (!load(in.c, true)) return false;
+            copy(CMP);
+            if (in.a >= top_ && in.a <= end_) jumpIf(failing((CmpOp)in.aux), false, in.a);
+            else jumpIf(failing((CmpOp)in.aux), true, exitAt(in.a, 0));
+            return true;
+        case Op::JumpIfFalse:
+            // an int (or a bool constant) is false when zero
+            if (depth_!=1) return false;
+            copy32(LOAD_RAX, tempAt(--depth_));
+            copy(TEST);
+            if (in.a >= top_ && in.a <= end_) jumpIf(E, false, in.a);
+            else jumpIf(E, true, exitAt(in.a, 0));
+            return true;
+        case Op::Jump: case Op::LoopNative:
+            if (depth_) return false;
+            if (metered_ && in.a <= pc) spendFuel(in.a);
+            jump(in.a);
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool LoopCompiler::compile(){
+    copy(PROLOGUE);
+    for (uint32_t pc = top_; pc <= end_; ++pc){
+        labels_[pc - top_] = out_.size();
+        if (!instr(pc)) return false;
+    }
+    // the backward jump ends the body; exits land here
+    vector<size_t> stubs;
+    vector<size_t> to_epilogue;
+    for (uint32_t i = 0; i < loop_.exits.size(); ++i){
+        stubs.push_back(out_.size());
+        copy32(EXIT, (int32_t)i);
+        copy(JMP);
+        to_epilogue.push_back(out_.size() - 4);
+    }
+    size_t epilogue = out_.size();
+    copy(EPILOGUE);
+    for (size_t at : to_epilogue){
+        int32_t rel = (int32_t)(epilogue - (at + 4));
+        patch(at, &rel, 4);
+    }
+    for (const Fixup& f : fixups_){
+        size_t target = f.exit ? stubs[f.target] : labels_[f.target - top_];
+        if (target==NONE) return false;
+        int32_t rel = (int32_t)(target - (f.at + 4));
+        patch(f.at, &rel, 4);
+    }
+    return true;
+}
+
+} // namespace
+
+unique_ptr<NativeLoop> LoopJit::compile(const Program& program, const vector<Instr>& code, uint32_t top, uint32_t end,
+                                        bool metered){
+    auto loop = make_unique<NativeLoop>();
+    LoopCompiler compiler(program, code, top, end, metered, *loop);
+    if (!compiler.compile()) return nullptr;
+
+    vector<uint8_t>& bytes = compiler.bytes();
+    size_t size = (bytes.size() + 4095) & ~(size_t)4095;
+    void* mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mem==MAP_FAILED) return nullptr;
+    memcpy(mem, bytes.data(), bytes.size());
+    if (mprotect(mem, size, PROT_READ | PROT_EXEC)!=0){
+        munmap(mem, size);
+        return nullptr;
+    }
+    loop->mem_ = mem;
+    loop->size_ = size;
+    loop->fn_ = reinterpret_cast<uint32_t (*)(int64_t*)>(mem);
+    return loop;
+}
+
+#endif
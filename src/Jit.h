@@ -0,0 +1,63 @@
+#pragma once
+#ifndef PYTHON_INTERPRETER_JIT_H
+#define PYTHON_INTERPRETER_JIT_H
+
+#include "Bytecode.h"
+
+// Machine code for one hot while-loop. It runs on an int64 register file:
+// every variable the loop touches is unboxed into regs[0..vars.size()) on
+// entry, expression temporaries live at regs[MAX_VARS..], and the code
+// returns the index of the Exit it left through. Leaving is how every slow
+// path is handled: on overflow, a zero divisor or the loop condition failing
+// the VM boxes the registers back and resumes the bytecode at exit.pc with
+// exit.depth temporaries pushed, so the bignum kernels take over from there.
+// A metered loop also spends regs[FUEL] on every backward jump and leaves
+// once it runs out, so a step budget (see Budget) can stop it.
+class NativeLoop {
+public:
+    static constexpr uint32_t MAX_VARS = 64;
+    static constexpr uint32_t MAX_TEMPS = 16;
+    static constexpr uint32_t FUEL = MAX_VARS + MAX_TEMPS;
+    static constexpr uint32_t REGS = FUEL + 2; // + one scratch word
+
+    struct Var {
+        bool global;    // global symbol, else a local slot of the running frame
+        uint32_t index;
+    };
+    struct Exit {
+        uint32_t pc;    // bytecode to resume at
+        uint32_t depth; // temporaries to push first
+    };
+
+    std::vector<Var> vars;
+    std::vector<Exit> exits;
+    uint32_t entry_failures = 0; // entries refused because a var was not a small int
+
+    NativeLoop() = default;
+    NativeLoop(const NativeLoop&) = delete;
+    NativeLoop& operator=(const NativeLoop&) = delete;
+    ~NativeLoop();
+
+    uint32_t run(int64_t* regs) const { return fn_(regs); }
+
+private:
+    friend class LoopJit;
+    void* mem_ = nullptr;
+    size_t size_ = 0;
+    uint32_t (*fn_)(int64_t*) = nullptr;
+};
+
+// Template JIT for the int subset of the bytecode (x86-64 Linux only). Each
+// supported instruction is copied from a fixed machine-code stencil whose
+// holes are patched with register offsets, immediates and jump distances.
+class LoopJit {
+public:
+    static bool available();
+
+    // Compiles code[top..end], end being the loop's backward jump; null when
+    // the loop does anything but int arithmetic, compares and jumps.
+    static std::unique_ptr<NativeLoop> compile(const Program& program, const std::vector<Instr>& code,
+                                               uint32_t top, uint32_t end, bool metered);
+};
+
+#endif // PYTHON_INTERPRETER_JIT_H
@@ -0,0 +1,263 @@
+#include "LoweringVisitor.h"
+#include "Python3Parser.h"
+#include "antlr4-runtime.h"
+using namespace std;
+
+Program LoweringVisitor::lower(Python3Parser::File_inputContext *ctx){
+    prog_.root = lowered(ctx);
+    return std::move(prog_);
+}
+
+NodeId LoweringVisitor::list(NodeKind kind, antlr4::ParserRuleContext *ctx, const vector<NodeId>& items){
+    NodeId id = prog_.add(kind, lineOf(ctx));
+    prog_.setList(id, items);
+    return id;
+}
+
+// Statements
+std::any LoweringVisitor::visitFile_input(Python3Parser::File_inputContext *ctx){
+    vector<NodeId> stmts;
+    for (auto st : ctx->stmt()) stmts.push_back(lowered(st));
+    NodeId root = prog_.add(NodeKind::Block, 1);
+    prog_.setList(root, stmts);
+    return root;
+}
+
+std::any LoweringVisitor::visitStmt(Python3Parser::StmtContext *ctx){
+    if (ctx->simple_stmt()) return visit(ctx->simple_stmt());
+    return visit(ctx->compound_stmt());
+}
+
+std::any LoweringVisitor::visitSimple_stmt(Python3Parser::Simple_stmtContext *ctx){
+    return visit(ctx->small_stmt());
+}
+
+std::any LoweringVisitor::visitSmall_stmt(Python3Parser::Small_stmtContext *ctx){
+    if (ctx->expr_stmt()) return visit(ctx->expr_stmt());
+    return visit(ctx->flow_stmt());
+}
+
+std::any LoweringVisitor::visitCompound_stmt(Python3Parser::Compound_stmtContext *ctx){
+    if (ctx->if_stmt()) return visit(ctx->if_stmt());
+    if (ctx->while_stmt()) return visit(ctx->while_stmt());
+    return visit(ctx->funcdef());
+}
+
+std::any LoweringVisitor::visitFuncdef(Python3Parser::FuncdefContext *ctx){
+    uint32_t name = prog_.addName(ctx->NAME()->getText());
+    vector<NodeId> params;
+    if (auto args = ctx->parameters()->typedargslist()){
+        // children: tfpdef ('=' test)? (',' tfpdef ('=' test)?)*
+        for (size_t i = 0; i < args->children.size(); ++i){
+            auto p = dynamic_cast<Python3Parser::TfpdefContext*>(args->children[i]);
+            if (!p) continue;
+            NodeId def = NO_NODE;
+            if (i + 2 < args->children.size() && args->children[i+1]->getText() == "=")
+                def = lowered(args->children[i+2]);
+            params.push_back(prog_.add(NodeKind::Param, lineOf(p), prog_.addName(p->NAME()->getText()), def));
+        }
+    }
+    NodeId body = lowered(ctx->suite());
+    NodeId id = prog_.add(NodeKind::FuncDef, lineOf(ctx), name, body);
+    prog_.setList(id, params);
+    return id;
+}
+
+std::any LoweringVisitor::visitSuite(Python3Parser::SuiteContext *ctx){
+    vector<NodeId> stmts;
+    if (ctx->simple_stmt()) stmts.push_back(lowered(ctx->simple_stmt()));
+    for (auto st : ctx->stmt()) stmts.push_back(lowered(st));
+    return list(NodeKind::Block, ctx, stmts);
+}
+
+std::any LoweringVisitor::visitIf_stmt(Python3Parser::If_stmtContext *ctx){
+    vector<NodeId> arms;
+    size_t k = ctx->test().size();
+    for (size_t i = 0; i < k; ++i){
+        arms.push_back(lowered(ctx->test(i)));
+        arms.push_back(lowered(ctx->suite(i)));
+    }
+    NodeId orelse = ctx->ELSE() ? lowered(ctx->suite(k)) : NO_NODE;
+    NodeId id = list(NodeKind::If, ctx, arms);
+    prog_.nodes[id].b = orelse;
+    return id;
+}
+
+std::any LoweringVisitor::visitWhile_stmt(Python3Parser::While_stmtContext *ctx){
+    NodeId cond = lowered(ctx->test());
+    NodeId body = lowered(ctx->suite());
+    return prog_.add(NodeKind::While, lineOf(ctx), cond, body);
+}
+
+std::any LoweringVisitor::visitFlow_stmt(Python3Parser::Flow_stmtContext *ctx){
+    if (ctx->break_stmt()) return visit(ctx->break_stmt());
+    if (ctx->continue_stmt()) return visit(ctx->continue_stmt());
+    return visit(ctx->return_stmt());
+}
+
+std::any LoweringVisitor::visitBreak_stmt(Python3Parser::Break_stmtContext *ctx){
+    return prog_.add(NodeKind::Break, lineOf(ctx));
+}
+
+std::any LoweringVisitor::visitContinue_stmt(Python3Parser::Continue_stmtContext *ctx){
+    return prog_.add(NodeKind::Continue, lineOf(ctx));
+}
+
+std::any LoweringVisitor::visitReturn_stmt(Python3Parser::Return_stmtContext *ctx){
+    NodeId value = ctx->testlist() ? lowered(ctx->testlist()) : NO_NODE;
+    return prog_.add(NodeKind::Return, lineOf(ctx), value);
+}
+
+std::any LoweringVisitor::visitExpr_stmt(Python3Parser::Expr_stmtContext *ctx){
+    if (auto aug = ctx->augassign()){
+        static const unordered_map<string, BinOp> ops = {
+            {"+=", BinOp::Add}, {"-=", BinOp::Sub}, {"*=", BinOp::Mul},
+            {"/=", BinOp::Div}, {"//=", BinOp::FloorDiv}, {"%=", BinOp::Mod},
+        };
+        NodeId lhs = lowered(ctx->testlist(0));
+        NodeId rhs = lowered(ctx->testlist(1));
+        return prog_.add(NodeKind::AugAssign, lineOf(ctx), lhs, rhs, (uint8_t)ops.at(aug->getText()));
+    }
+    vector<NodeId> parts;
+    for (auto t : ctx->testlist()) parts.push_back(lowered(t));
+    if (parts.size()==1) return prog_.add(NodeKind::ExprStmt, lineOf(ctx), parts[0]);
+    return list(NodeKind::Assign, ctx, parts);
+}
+
+// Expressions
+std::any LoweringVisitor::visitTestlist(Python3Parser::TestlistContext *ctx){
+    auto tests = ctx->test();
+    if (tests.size()==1 && ctx->COMMA().empty()) return visit(tests[0]);
+    vector<NodeId> items;
+    for (auto t : tests) items.push_back(lowered(t));
+    return list(NodeKind::Tuple, ctx, items);
+}
+
+std::any LoweringVisitor::visitTest(Python3Parser::TestContext *ctx){
+    return visit(ctx->or_test());
+}
+
+std::any LoweringVisitor::visitOr_test(Python3Parser::Or_testContext *ctx){
+    auto operands = ctx->and_test();
+    if (operands.size()==1) return visit(operands[0]);
+    vector<NodeId> items;
+    for (auto a : operands) items.push_back(lowered(a));
+    return list(NodeKind::Or, ctx, items);
+}
+
+std::any LoweringVisitor::visitAnd_test(Python3Parser::And_testContext *ctx){
+    auto operands = ctx->not_test();
+    if (operands.size()==1) return visit(operands[0]);
+    vector<NodeId> items;
+    for (auto n : operands) items.push_back(lowered(n));
+    return list(NodeKind::And, ctx, items);
+}
+
+std::any LoweringVisitor::visitNot_test(Python3Parser::Not_testContext *ctx){
+    if (ctx->NOT()){
+        NodeId operand = lowered(ctx->not_test());
+        return prog_.add(NodeKind::Not, lineOf(ctx), operand);
+    }
+    return visit(ctx->comparison());
+}
+
+std::any LoweringVisitor::visitComparison(Python3Parser::ComparisonContext *ctx){
+    static const unordered_map<string, CmpOp> ops = {
+        {"<", CmpOp::Lt}, {">", CmpOp::Gt}, {"==", CmpOp::Eq},
+        {">=", CmpOp::Ge}, {"<=", CmpOp::Le}, {"!=", CmpOp::Ne},
+    };
+    auto operands = ctx->arith_expr();
+    if (operands.size()==1) return visit(operands[0]);
+    vector<NodeId> items{lowered(operands[0])};
+    for (size_t i = 1; i < operands.size(); ++i){
+        items.push_back((NodeId)ops.at(ctx->comp_op(i-1)->getText()));
+        items.push_back(lowered(operands[i]));
+    }
+    return list(NodeKind::Compare, ctx, items);
+}
+
+std::any LoweringVisitor::visitArith_expr(Python3Parser::Arith_exprContext *ctx){
+    NodeId cur = lowered(ctx->term(0));
+    for (size_t i = 1; i < ctx->term().size(); ++i){
+        auto op = ctx->addorsub_op(i-1);
+        BinOp bop = op->getText()=="+" ? BinOp::Add : BinOp::Sub;
+        NodeId rhs = lowered(ctx->term(i));
+        cur = prog_.add(NodeKind::Binary, lineOf(op), cur, rhs, (uint8_t)bop);
+    }
+    return cur;
+}
+
+std::any LoweringVisitor::visitTerm(Python3Parser::TermContext *ctx){
+    static const unordered_map<string, BinOp> ops = {
+        {"*", BinOp::Mul}, {"/", BinOp::Div}, {"//", BinOp::FloorDiv}, {"%", BinOp::Mod},
+    };
+    NodeId cur = lowered(ctx->factor(0));
+    for (size_t i = 1; i < ctx->factor().size(); ++i){
+        auto op = ctx->muldivmod_op(i-1);
+        NodeId rhs = lowered(ctx->factor(i));
+        cur = prog_.add(NodeKind::Binary, lineOf(op), cur, rhs, (uint8_t)ops.at(op->getText()));
+    }
+    return cur;
+}
+
+std::any LoweringVisitor::visitFactor(Python3Parser::FactorContext *ctx){
+    if (ctx->atom_expr()) return visit(ctx->atom_expr());
+    UnaryOp op = ctx->MINUS() ? UnaryOp::Neg : UnaryOp::Pos;
+    NodeId operand = lowered(ctx->factor());
+    return prog_.add(NodeKind::Unary, lineOf(ctx), operand, NO_NODE, (uint8_t)op);
+}
+
+std::any LoweringVisitor::visitAtom_expr(Python3Parser::Atom_exprContext *ctx){
+    NodeId atom = lowered(ctx->atom());
+    auto tr = ctx->trailer();
+    if (!tr) return atom;
+    vector<NodeId> args;
+    if (tr->arglist()){
+        for (auto arg : tr->arglist()->argument()){
+            if (arg->ASSIGN()){
+                NodeId key = lowered(arg->test(0));
+                uint32_t name = prog_[key].kind==NodeKind::Name ? prog_[key].a : NO_NODE;
+                NodeId value = lowered(arg->test(1));
+                args.push_back(prog_.add(NodeKind::Keyword, lineOf(arg), name, value));
+            }else{
+                args.push_back(lowered(arg->test(0)));
+            }
+        }
+    }
+    bool named = prog_[atom].kind==NodeKind::Name;
+    NodeId call = list(NodeKind::Call, ctx, args);
+    prog_.nodes[call].a = named ? prog_[atom].a : NO_NODE;
+    prog_.nodes[call].b = named ? NO_NODE : atom;
+    return call;
+}
+
+std::any LoweringVisitor::visitAtom(Python3Parser::AtomContext *ctx){
+    uint32_t line = lineOf(ctx);
+    if (ctx->NAME()) return prog_.add(NodeKind::Name, line, prog_.addName(ctx->NAME()->getText()));
+    if (ctx->NUMBER()) return prog_.add(NodeKind::Const, line, prog_.addConstant(parseNumber(ctx->NUMBER()->getText())));
+    if (ctx->NONE()) return prog_.add(NodeKind::Const, line, prog_.addConstant(Value::None()));
+    if (ctx->TRUE()) return prog_.add(NodeKind::Const, line, prog_.addConstant(Value::fromBool(true)));
+    if (ctx->FALSE()) return prog_.add(NodeKind::Const, line, prog_.addConstant(Value::fromBool(false)));
+    if (ctx->OPEN_PAREN()) return visit(ctx->test());
+    if (!ctx->STRING().empty()){
+        string out;
+        for (auto tn : ctx->STRING()) out += parseStringToken(tn->getText());
+        return prog_.add(NodeKind::Const, line, prog_.addConstant(Value::fromStr(std::move(out))));
+    }
+    return visit(ctx->format_string());
+}
+
+std::any LoweringVisitor::visitFormat_string(Python3Parser::Format_stringContext *ctx){
+    vector<NodeId> parts;
+    for (auto *child : ctx->children){
+        if (auto* tn = dynamic_cast<antlr4::tree::TerminalNode*>(child)){
+            if (tn->getSymbol()->getType() == Python3Parser::FORMAT_STRING_LITERAL){
+                Value frag = Value::fromStr(parseFormatLiteral(tn->getText()));
+                parts.push_back(prog_.add(NodeKind::Const, (uint32_t)tn->getSymbol()->getLine(), prog_.addConstant(std::move(frag))));
+            }
+        } else if (auto* tl = dynamic_cast<Python3Parser::TestlistContext*>(child)){
+            parts.push_back(lowered(tl));
+        }
+    }
+    return list(NodeKind::FString, ctx, parts);
+}
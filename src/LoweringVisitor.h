@@ -0,0 +1,53 @@
+#pragma once
+#ifndef PYTHON_INTERPRETER_LOWERING_VISITOR_H
+#define PYTHON_INTERPRETER_LOWERING_VISITOR_H
+
+#include "Ast.h"
+#include "Python3ParserBaseVisitor.h"
+
+// Converts an ANTLR parse tree into the same self-contained Program that
+// NativeParser builds. Every visit returns the NodeId of the lowered subtree,
+// so once lower() returns the parse tree, parser and tokens can be dropped.
+class LoweringVisitor : public Python3ParserBaseVisitor {
+public:
+    Program lower(Python3Parser::File_inputContext *ctx);
+
+    // statements
+    std::any visitFile_input(Python3Parser::File_inputContext *ctx) override;
+    std::any visitFuncdef(Python3Parser::FuncdefContext *ctx) override;
+    std::any visitStmt(Python3Parser::StmtContext *ctx) override;
+    std::any visitSimple_stmt(Python3Parser::Simple_stmtContext *ctx) override;
+    std::any visitSmall_stmt(Python3Parser::Small_stmtContext *ctx) override;
+    std::any visitExpr_stmt(Python3Parser::Expr_stmtContext *ctx) override;
+    std::any visitFlow_stmt(Python3Parser::Flow_stmtContext *ctx) override;
+    std::any visitBreak_stmt(Python3Parser::Break_stmtContext *ctx) override;
+    std::any visitContinue_stmt(Python3Parser::Continue_stmtContext *ctx) override;
+    std::any visitReturn_stmt(Python3Parser::Return_stmtContext *ctx) override;
+    std::any visitCompound_stmt(Python3Parser::Compound_stmtContext *ctx) override;
+    std::any visitIf_stmt(Python3Parser::If_stmtContext *ctx) override;
+    std::any visitWhile_stmt(Python3Parser::While_stmtContext *ctx) override;
+    std::any visitSuite(Python3Parser::SuiteContext *ctx) override;
+
+    // expressions
+    std::any visitTest(Python3Parser::TestContext *ctx) override;
+    std::any visitOr_test(Python3Parser::Or_testContext *ctx) override;
+    std::any visitAnd_test(Python3Parser::And_testContext *ctx) override;
+    std::any visitNot_test(Python3Parser::Not_testContext *ctx) override;
+    std::any visitComparison(Python3Parser::ComparisonContext *ctx) override;
+    std::any visitArith_expr(Python3Parser::Arith_exprContext *ctx) override;
+    std::any visitTerm(Python3Parser::TermContext *ctx) override;
+    std::any visitFactor(Python3Parser::FactorContext *ctx) override;
+    std::any visitAtom_expr(Python3Parser::Atom_exprContext *ctx) override;
+    std::any visitAtom(Python3Parser::AtomContext *ctx) override;
+    std::any visitFormat_string(Python3Parser::Format_stringContext *ctx) override;
+    std::any visitTestlist(Python3Parser::TestlistContext *ctx) override;
+
+private:
+    Program prog_;
+
+    NodeId lowered(antlr4::tree::ParseTree *tree) { return std::any_cast<NodeId>(visit(tree)); }
+    NodeId list(NodeKind kind, antlr4::ParserRuleContext *ctx, const std::vector<NodeId> &items);
+    static uint32_t lineOf(antlr4::ParserRuleContext *ctx) { return (uint32_t)ctx->getStart()->getLine(); }
+};
+
+#endif // PYTHON_INTERPRETER_LOWERING_VISITOR_H
@@ -0,0 +1,183 @@
+#include "Memory.h"
+#include <cstdlib>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#define MEMORY_COUNTED 1
+#else
+#define MEMORY_COUNTED 0
+#endif
+using namespace std;
+
+static const char* const CATEGORY_NAMES[Memory::CATEGORIES] = {
+    "bignum limbs", "strings", "environments", "program", "parse", "other",
+};
+static constexpr size_t MIN_CHECK_STEP = size_t(1) << 20;
+
+// single-threaded: the interpreter is the only allocating thread
+static size_t live_bytes = 0;
+static size_t peak_bytes = 0;
+static size_t next_check = SIZE_MAX; // live bytes that make the next checkpoint due
+static bool accounting = false;
+static bool limit_exceeded = false;
+static size_t soft_limit = 0;
+static size_t parse_base = 0, parse_peak_before = 0;
+static Memory::Usage last_usage, peak_usage;
+static size_t last_live = 0; // live bytes at the last checkpoint, which last_usage splits
+
+volatile sig_atomic_t Memory::due_ = 0;
+volatile sig_atomic_t Memory::report_requested_ = 0;
+
+static inline void allocated(size_t bytes){
+    live_bytes += bytes;
+    if (live_bytes > peak_bytes) peak_bytes = live_bytes;
+    if (live_bytes > next_check) Memory::requestCheck();
+}
+
+static inline void released(size_t bytes){
+    // blocks allocated before enable() were never added
+    live_bytes -= min(bytes, live_bytes);
+}
+
+#if MEMORY_COUNTED
+void* operator new(size_t n){
+    void* p = malloc(n ? n : 1);
+    if (!p) throw bad_alloc();
+    if (accounting) allocated(malloc_usable_size(p));
+    return p;
+}
+
+void* operator new(size_t n, align_val_t align){
+    void* p = nullptr;
+    if (posix_memalign(&p, max((size_t)align, sizeof(void*)), n ? n : 1)!=0) throw bad_alloc();
+    if (accounting) allocated(malloc_usable_size(p));
+    return p;
+}
+
+void operator delete(void* p) noexcept{
+    if (!p) return;
+    if (accounting) released(malloc_usable_size(p));
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept{ operator delete(p); }
+void operator delete(void* p, align_val_t) noexcept{ operator delete(p); }
+void operator delete(void* p, size_t, align_val_t) noexcept{ operator delete(p); }
+#endif
+
+void Memory::requestCheck(){
+    due_ = 1;
+}
+
+void Memory::onReportSignal(int){
+    report_requested_ = 1;
+    due_ = 1;
+}
+
+static void scheduleCheck(){
+    next_check = live_bytes + max(live_bytes / 8, MIN_CHECK_STEP);
+    if (soft_limit && live_bytes <= soft_limit) next_check = min(next_check, soft_limit);
+}
+
+void Memory::enable(size_t limit){
+    accounting = true;
+    soft_limit = limit;
+    scheduleCheck();
+    signal(SIGUSR1, onReportSignal);
+}
+
+void Memory::reset(){
+    peak_bytes = live_bytes;
+    limit_exceeded = false;
+    last_usage = peak_usage = Usage();
+    last_live = 0;
+    due_ = 0;
+    scheduleCheck();
+}
+
+bool Memory::enabled(){ return accounting; }
+bool Memory::limitExceeded(){ return limit_exceeded; }
+size_t Memory::live(){ return live_bytes; }
+size_t Memory::peak(){ return peak_bytes; }
+
+// peak_bytes restarts from live so the parse's own high-water mark shows
+void Memory::beginParse(){
+    parse_base = live_bytes;
+    parse_peak_before = peak_bytes;
+    peak_bytes = live_bytes;
+}
+
+void Memory::endParse(){
+    // what survives parsing is the Program; the rest was tokens and trees
+    size_t kept = live_bytes > parse_base ? live_bytes - parse_base : 0;
+    size_t high = peak_bytes - parse_base;
+    peak_usage.bytes[PARSE] = high > kept ? high - kept : 0;
+    peak_bytes = max(peak_bytes, parse_peak_before);
+}
+
+void Memory::addValue(Usage& usage, const Value& v){
+    using Backend = boost::multiprecision::cpp_int::backend_type;
+    if (v.type==Value::Type::INT){
+        unsigned capacity = v.i.backend().capacity();
+        if (capacity > Backend::internal_limb_count) usage.bytes[BIGNUM] += capacity * sizeof(boost::multiprecision::limb_type);
+    }else if (v.type==Value::Type::STR){
+        // short strings live inside the Value
+        const char* data = v.s.data();
+        const char* self = reinterpret_cast<const char*>(&v.s);
+        if (data < self || data >= self + sizeof(v.s)) usage.bytes[STRING] += v.s.capacity() + 1;
+    }
+}
+
+void Memory::addProgram(Usage& usage, const Program& program){
+    size_t& bytes = usage.bytes[PROGRAM];
+    bytes += program.nodes.capacity() * sizeof(Node) + program.lists.capacity() * sizeof(NodeId);
+    bytes += program.constants.capacity() * sizeof(Value);
+    for (const Value& c : program.constants) addValue(usage, c);
+    bytes += program.names.capacity() * sizeof(string);
+    for (const string& name : program.names) bytes += name.capacity() > 15 ? name.capacity() + 1 : 0;
+    // node per entry (key, value, next, hash) plus the bucket array
+    bytes += program.symbols.size() * (sizeof(pair<const string, uint32_t>) + 2 * sizeof(void*));
+    bytes += program.symbols.bucket_count() * sizeof(void*);
+}
+
+void Memory::checkpoint(Usage& usage){
+    due_ = 0;
+    size_t known = 0;
+    for (int c = 0; c < OTHER; ++c) known += usage.bytes[c];
+    usage.bytes[PARSE] = 0;
+    usage.bytes[OTHER] = live_bytes > known ? live_bytes - known : 0;
+    for (int c = 0; c < CATEGORIES; ++c) peak_usage.bytes[c] = max(peak_usage.bytes[c], usage.bytes[c]);
+    last_usage = usage;
+    last_live = live_bytes;
+    if (report_requested_){
+        report_requested_ = 0;
+        cout.flush();
+        report(cerr);
+    }
+    scheduleCheck();
+    if (soft_limit && live_bytes > soft_limit){
+        limit_exceeded = true;
+        cout.flush();
+        report(cerr);
+        throw runtime_error("MemoryError: soft limit of " + to_string(soft_limit >> 20) + " MiB exceeded ("
+                            + to_string(live_bytes >> 20) + " MiB live)");
+    }
+}
+
+void Memory::report(ostream& out){
+    auto mib = [](size_t bytes){ return bytes / 1048576.0; };
+    char buf[128];
+    snprintf(buf, sizeof buf, "memory: live %.3f MiB, peak %.3f MiB", mib(live_bytes), mib(peak_bytes));
+    out << buf;
+    if (soft_limit) out << ", soft limit " << (soft_limit >> 20) << " MiB";
+    if (!MEMORY_COUNTED) out << " (not counted on this platform)";
+    // live bytes move on after a checkpoint (the engine is gone by the final
+    // report), so the split is labelled as the checkpoint's and totalled
+    out << "\ncategory        checkpoint    peak MiB\n";
+    for (int c = 0; c < CATEGORIES; ++c){
+        snprintf(buf, sizeof buf, "%-14s %11.3f %11.3f\n", CATEGORY_NAMES[c], mib(last_usage.bytes[c]),
+                 mib(peak_usage.bytes[c]));
+        out << buf;
+    }
+    snprintf(buf, sizeof buf, "%-14s %11.3f\n", "total", mib(last_live));
+    out << buf;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#ifndef PYTHON_INTERPRETER_MEMORY_H
+#define PYTHON_INTERPRETER_MEMORY_H
+
+#include "Ast.h"
+#include <csignal>
+#include <new>
+
+// Memory accounting (--memory-report, --memory-limit=MiB). Once enabled, the
+// replaced global operator new/delete keep exact live and peak heap bytes
+// (glibc's malloc_usable_size; elsewhere they count nothing); until then
+// they cost one flag test over malloc and free. Splitting that total
+// into categories takes a walk over an engine's values, so it happens at
+// checkpoints: whenever live bytes have grown by an eighth since the last
+// one, cross the soft limit, or SIGUSR1 asks for a report. The engine runs
+// the checkpoint at its next statement or instruction.
+//
+// The report's checkpoint column is the last checkpoint's split (its total
+// is what was live then, not now); category peaks are the highest seen at a
+// checkpoint, except parse, whose tokens and ANTLR tree are measured exactly
+// around parsing. Over the soft
+// limit a checkpoint prints the report and throws a MemoryError, so the
+// script fails cleanly long before the OOM killer would end it.
+class Memory {
+public:
+    enum Category { BIGNUM, STRING, ENVIRONMENT, PROGRAM, PARSE, OTHER, CATEGORIES };
+    struct Usage {
+        size_t bytes[CATEGORIES] = {};
+    };
+
+    // soft_limit in bytes, 0 for none; also installs the SIGUSR1 handler
+    static void enable(size_t soft_limit);
+    static bool enabled();
+    // starts a new run (a batch's next script): peaks restart from what is
+    // live now, category figures and the exceeded flag are cleared
+    static void reset();
+    static bool limitExceeded(); // a checkpoint threw (and reported)
+    static size_t live();
+    static size_t peak();
+
+    // parsing runs between these; what it frees by the end was tokens and tree
+    static void beginParse();
+    static void endParse();
+
+    static bool due() { return due_ != 0; }
+    static void requestCheck(); // make the next safe point run a checkpoint
+    // usage holds the engine's walk (environments and the values in them)
+    static void checkpoint(Usage& usage);
+    static void report(std::ostream& out);
+
+    // helpers for the engines' walks
+    static void addValue(Usage& usage, const Value& v);       // bignum / string payload
+    static void addProgram(Usage& usage, const Program& program);
+
+private:
+    static volatile std::sig_atomic_t due_;
+    static volatile std::sig_atomic_t report_requested_;
+    static void onReportSignal(int);
+};
+
+#endif // PYTHON_INTERPRETER_MEMORY_H
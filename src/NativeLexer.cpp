@@ -0,0 +1,278 @@
+#include "NativeLexer.h"
+#include <cstring>
+using namespace std;
+
+static bool isIdStart(int c){ return c=='_' || (c>='a'&&c<='z') || (c>='A'&&c<='Z') || c>=0x80; }
+static bool isIdContinue(int c){ return isIdStart(c) || (c>='0'&&c<='9'); }
+static bool isDigit(int c){ return c>='0' && c<='9'; }
+
+static TokenType keyword(string_view w){
+    switch (w.size()){
+        case 2: if (w=="if") return TK_IF; if (w=="in") return TK_IN; if (w=="or") return TK_OR; break;
+        case 3: if (w=="def") return TK_DEF; if (w=="for") return TK_FOR; if (w=="and") return TK_AND; if (w=="not") return TK_NOT; break;
+        case 4: if (w=="elif") return TK_ELIF; if (w=="else") return TK_ELSE; if (w=="None") return TK_NONE; if (w=="True") return TK_TRUE; break;
+        case 5: if (w=="while") return TK_WHILE; if (w=="False") return TK_FALSE; if (w=="break") return TK_BREAK; break;
+        case 6: if (w=="return") return TK_RETURN; break;
+        case 8: if (w=="continue") return TK_CONTINUE; break;
+    }
+    return TK_NAME;
+}
+
+NativeLexer::NativeLexer(string_view source) : src_(source) {
+    out_.source = source;
+    out_.line_starts.push_back(0);
+}
+
+void NativeLexer::emit(TokenType type, size_t begin, size_t end, uint32_t line){
+    out_.tokens.push_back(TokenRecord{type, line, (uint32_t)begin, (uint32_t)(end - begin)});
+}
+
+// Record that a '\n' was consumed at offset `at`.
+void NativeLexer::newLine(size_t at){
+    ++line_;
+    out_.line_starts.push_back((uint32_t)(at + 1));
+}
+
+TokenBuffer NativeLexer::run(){
+    out_.tokens.reserve(src_.size() / 3 + 16);
+    // Leading whitespace on the first line goes through the NEWLINE rule.
+    if (peek()==' ' || peek()=='\t') lexNewline(true);
+    while (pos_ < src_.size()){
+        int c = peek();
+        if (format_mode_ > 0 && !expr_mode_ && c!='\r' && c!='\n' && c!='\f'){
+            lexFormatLiteral();
+            continue;
+        }
+        if (c=='\n' || c=='\r' || c=='\f'){ lexNewline(false); continue; }
+        if (c==' ' || c=='\t'){ while (peek()==' ' || peek()=='\t') ++pos_; continue; }
+        if (c=='#'){ while (pos_<src_.size() && peek()!='\n' && peek()!='\r' && peek()!='\f') ++pos_; continue; }
+        if (c=='\\'){
+            // line joining: '\' SPACES? newline
+            size_t p = pos_ + 1;
+            while (p<src_.size() && (src_[p]==' ' || src_[p]=='\t')) ++p;
+            if (p<src_.size() && (src_[p]=='\n' || src_[p]=='\r' || src_[p]=='\f')){
+                if (src_[p]=='\r' && p+1<src_.size() && src_[p+1]=='\n') ++p;
+                if (src_[p]=='\n') newLine(p);
+                pos_ = p + 1;
+                continue;
+            }
+            emit(TK_UNKNOWN_CHAR, pos_, pos_+1); ++pos_;
+            continue;
+        }
+        if (isIdStart(c)){ lexName(); continue; }
+        if (isDigit(c) || (c=='.' && isDigit(peek(1)))){ lexNumber(); continue; }
+        if (c=='"' || c=='\''){ lexString(pos_); continue; }
+        lexOperator();
+    }
+    finish();
+    return std::move(out_);
+}
+
+// NEWLINE: ({atStartOfInput()}? SPACES | ('\r'? '\n' | '\r' | '\f') SPACES?)
+// followed by the indentation bookkeeping of Python3Lexer.g4.
+void NativeLexer::lexNewline(bool at_start){
+    size_t begin = pos_;
+    uint32_t line = line_;
+    if (!at_start){
+        if (peek()=='\r' && peek(1)=='\n') ++pos_;
+        if (peek()=='\n') newLine(pos_);
+        ++pos_;
+    }
+    size_t nl_end = pos_;
+    int indent = 0;
+    while (peek()==' ' || peek()=='\t'){
+        if (peek()=='\t') indent += 8 - indent % 8; else ++indent;
+        ++pos_;
+    }
+    int next = peek();
+    // Inside brackets or on a blank/comment-only line: no layout tokens.
+    if (opened_ > 0 || next=='\r' || next=='\n' || next=='\f' || next=='#') return;
+    emit(TK_NEWLINE, begin, nl_end, line);
+    int previous = indents_.empty() ? 0 : indents_.back();
+    if (indent > previous){
+        indents_.push_back(indent);
+        emit(TK_INDENT, nl_end, pos_);
+    }else{
+        while (!indents_.empty() && indents_.back() > indent){
+            emit(TK_DEDENT, pos_, pos_);
+            indents_.pop_back();
+        }
+    }
+}
+
+// Text between the quotes of an f-string, outside of any {...}.
+void NativeLexer::lexFormatLiteral(){
+    int c = peek();
+    if (c=='"'){
+        emit(TK_QUOTATION, pos_, pos_+1); ++pos_;
+        if (--format_mode_ > 0) expr_mode_ = true;
+        return;
+    }
+    if (c=='{' && peek(1)!='{'){
+        emit(TK_OPEN_BRACE, pos_, pos_+1); ++pos_;
+        ++opened_; expr_mode_ = true;
+        return;
+    }
+    if (c=='}' && peek(1)!='}'){
+        emit(TK_CLOSE_BRACE, pos_, pos_+1); ++pos_;
+        --opened_; expr_mode_ = false;
+        return;
+    }
+    size_t begin = pos_;
+    uint32_t line = line_;
+    while (pos_ < src_.size()){
+        c = peek();
+        if (c=='\\' && pos_+1 < src_.size()){
+            if (src_[pos_+1]=='\n') newLine(pos_+1);
+            pos_ += 2;
+        }else if ((c=='{' && peek(1)=='{') || (c=='}' && peek(1)=='}')){
+            pos_ += 2;
+        }else if (c=='"' || c=='{' || c=='}' || c=='\r' || c=='\n' || c=='\f'){
+            break;
+        }else{
+            ++pos_;
+        }
+    }
+    emit(TK_FORMAT_STRING_LITERAL, begin, pos_, line);
+}
+
+void NativeLexer::lexName(){
+    size_t begin = pos_;
+    // string prefixes: f" opens an f-string; r/u/fr/rf and b/br/rb prefix a literal
+    int c0 = peek(), c1 = peek(1), c2 = peek(2);
+    auto isQuote = [](int c){ return c=='"' || c=='\''; };
+    if (c0=='f' && c1=='"'){
+        emit(TK_FORMAT_QUOTATION, pos_, pos_+2); pos_ += 2;
+        ++format_mode_; expr_mode_ = false;
+        return;
+    }
+    auto lower = [](int c){ return (c>='A' && c<='Z') ? c + 32 : c; };
+    int l0 = lower(c0), l1 = lower(c1);
+    if (isQuote(c1) && (l0=='r' || l0=='u' || l0=='b')){ pos_ += 1; lexString(begin); return; }
+    if (isQuote(c2) && ((l0=='f' && l1=='r') || (l0=='r' && l1=='f') || (l0=='b' && l1=='r') || (l0=='r' && l1=='b'))){
+        pos_ += 2; lexString(begin); return;
+    }
+    while (isIdContinue(peek())) ++pos_;
+    emit(keyword(src_.substr(begin, pos_ - begin)), begin, pos_);
+}
+
+// NUMBER: INTEGER | FLOAT_NUMBER | IMAG_NUMBER, longest match.
+void NativeLexer::lexNumber(){
+    size_t begin = pos_;
+    int c1 = peek(1) | 0x20;
+    if (peek()=='0' && (c1=='x' || c1=='o' || c1=='b')){
+        auto ok = [c1](int c){
+            if (c1=='x') return isDigit(c) || ((c|0x20)>='a' && (c|0x20)<='f');
+            if (c1=='o') return c>='0' && c<='7';
+            return c=='0' || c=='1';
+        };
+        if (ok(peek(2))){
+            pos_ += 2;
+            while (ok(peek())) ++pos_;
+            emit(TK_NUMBER, begin, pos_);
+            return;
+        }
+    }
+    while (isDigit(peek())) ++pos_;
+    size_t int_end = pos_;
+    bool is_float = false;
+    if (peek()=='.' && (int_end > begin || isDigit(peek(1)))){
+        ++pos_; is_float = true;
+        while (isDigit(peek())) ++pos_;
+    }
+    if ((peek()=='e' || peek()=='E')){
+        size_t p = pos_ + 1;
+        if (p<src_.size() && (src_[p]=='+' || src_[p]=='-')) ++p;
+        if (p<src_.size() && isDigit((unsigned char)src_[p])){
+            while (p<src_.size() && isDigit((unsigned char)src_[p])) ++p;
+            pos_ = p; is_float = true;
+        }
+    }
+    if (peek()=='j' || peek()=='J'){
+        ++pos_; is_float = true;
+    }
+    if (!is_float && src_[begin]=='0'){
+        // DECIMAL_INTEGER: NON_ZERO_DIGIT DIGIT* | '0'+
+        pos_ = begin;
+        while (peek()=='0') ++pos_;
+    }
+    emit(TK_NUMBER, begin, pos_);
+}
+
+// Short or long string starting at the quote under pos_; `begin` includes any prefix.
+void NativeLexer::lexString(size_t begin){
+    uint32_t line = line_;
+    char q = src_[pos_];
+    bool is_long = peek(1)==q && peek(2)==q;
+    pos_ += is_long ? 3 : 1;
+    while (pos_ < src_.size()){
+        int c = peek();
+        if (c=='\\' && pos_+1 < src_.size()){
+            if (src_[pos_+1]=='\r' && pos_+2 < src_.size() && src_[pos_+2]=='\n') ++pos_;
+            if (src_[pos_+1]=='\n') newLine(pos_+1);
+            pos_ += 2;
+            continue;
+        }
+        if (is_long){
+            if (c==q && peek(1)==q && peek(2)==q){ pos_ += 3; emit(TK_STRING, begin, pos_, line); return; }
+            if (c=='\n') newLine(pos_);
+            ++pos_;
+        }else{
+            if (c==q){ ++pos_; emit(TK_STRING, begin, pos_, line); return; }
+            if (c=='\r' || c=='\n' || c=='\f') break;
+            ++pos_;
+        }
+    }
+    // unterminated: the opening quote is an unknown character
+    pos_ = begin + 1;
+    line_ = line;
+    while (out_.line_starts.size() > line_) out_.line_starts.pop_back();
+    emit(TK_UNKNOWN_CHAR, begin, pos_);
+}
+
+void NativeLexer::lexOperator(){
+    struct Op { const char* text; TokenType type; };
+    // longest spellings first
+    static const Op ops[] = {
+        {"...", TK_ELLIPSIS}, {"**=", TK_POWER_ASSIGN}, {"//=", TK_IDIV_ASSIGN},
+        {"<<=", TK_LEFT_SHIFT_ASSIGN}, {">>=", TK_RIGHT_SHIFT_ASSIGN},
+        {"**", TK_POWER}, {"//", TK_IDIV}, {"<<", TK_LEFT_SHIFT}, {">>", TK_RIGHT_SHIFT},
+        {"==", TK_EQUALS}, {">=", TK_GT_EQ}, {"<=", TK_LT_EQ}, {"<>", TK_NOT_EQ_1}, {"!=", TK_NOT_EQ_2},
+        {"->", TK_ARROW}, {"+=", TK_ADD_ASSIGN}, {"-=", TK_SUB_ASSIGN}, {"*=", TK_MULT_ASSIGN},
+        {"@=", TK_AT_ASSIGN}, {"/=", TK_DIV_ASSIGN}, {"%=", TK_MOD_ASSIGN}, {"&=", TK_AND_ASSIGN},
+        {"|=", TK_OR_ASSIGN}, {"^=", TK_XOR_ASSIGN},
+        {".", TK_DOT}, {"*", TK_STAR}, {"(", TK_OPEN_PAREN}, {")", TK_CLOSE_PAREN}, {",", TK_COMMA},
+        {":", TK_COLON}, {";", TK_SEMI_COLON}, {"=", TK_ASSIGN}, {"[", TK_OPEN_BRACK}, {"]", TK_CLOSE_BRACK},
+        {"|", TK_OR_OP}, {"^", TK_XOR}, {"&", TK_AND_OP}, {"+", TK_ADD}, {"-", TK_MINUS}, {"/", TK_DIV},
+        {"%", TK_MOD}, {"~", TK_NOT_OP}, {"{", TK_OPEN_BRACE}, {"}", TK_CLOSE_BRACE},
+        {"<", TK_LESS_THAN}, {">", TK_GREATER_THAN}, {"@", TK_AT},
+    };
+    string_view rest = src_.substr(pos_);
+    for (const Op& op : ops){
+        size_t len = strlen(op.text);
+        if (rest.compare(0, len, op.text) != 0) continue;
+        emit(op.type, pos_, pos_+len);
+        pos_ += len;
+        switch (op.type){
+            case TK_OPEN_PAREN: case TK_OPEN_BRACK: ++opened_; break;
+            case TK_CLOSE_PAREN: case TK_CLOSE_BRACK: --opened_; break;
+            case TK_OPEN_BRACE: ++opened_; expr_mode_ = true; break;
+            case TK_CLOSE_BRACE: --opened_; expr_mode_ = false; break;
+            default: break;
+        }
+        return;
+    }
+    emit(TK_UNKNOWN_CHAR, pos_, pos_+1);
+    ++pos_;
+}
+
+// End of input: terminate the last logical line, close every open block.
+void NativeLexer::finish(){
+    if (!out_.tokens.empty() && out_.tokens.back().type!=TK_NEWLINE && out_.tokens.back().type!=TK_DEDENT)
+        emit(TK_NEWLINE, pos_, pos_);
+    while (!indents_.empty()){
+        emit(TK_DEDENT, pos_, pos_);
+        indents_.pop_back();
+    }
+    emit(TK_EOF, pos_, pos_);
+}
@@ -0,0 +1,84 @@
+#pragma once
+#ifndef PYTHON_INTERPRETER_NATIVE_LEXER_H
+#define PYTHON_INTERPRETER_NATIVE_LEXER_H
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Token kinds. The numeric values are the ids generated in Python3Lexer.h, so
+// a record can be handed to the ANTLR parser without translation.
+enum TokenType : uint8_t {
+    TK_EOF = 0,
+    TK_INDENT = 1, TK_DEDENT = 2, TK_STRING = 3, TK_NUMBER = 4,
+    TK_DEF = 6, TK_RETURN = 7, TK_IF = 8, TK_ELIF = 9, TK_ELSE = 10, TK_WHILE = 11,
+    TK_FOR = 12, TK_IN = 13, TK_OR = 14, TK_AND = 15, TK_NOT = 16, TK_NONE = 17,
+    TK_TRUE = 18, TK_FALSE = 19, TK_CONTINUE = 20, TK_BREAK = 21,
+    TK_NEWLINE = 22, TK_NAME = 23, TK_FORMAT_STRING_LITERAL = 25,
+    TK_DOT = 33, TK_ELLIPSIS = 34, TK_STAR = 35, TK_OPEN_PAREN = 36, TK_CLOSE_PAREN = 37,
+    TK_COMMA = 38, TK_COLON = 39, TK_SEMI_COLON = 40, TK_POWER = 41, TK_ASSIGN = 42,
+    TK_OPEN_BRACK = 43, TK_CLOSE_BRACK = 44, TK_OR_OP = 45, TK_XOR = 46, TK_AND_OP = 47,
+    TK_LEFT_SHIFT = 48, TK_RIGHT_SHIFT = 49, TK_ADD = 50, TK_MINUS = 51, TK_DIV = 52,
+    TK_MOD = 53, TK_IDIV = 54, TK_NOT_OP = 55, TK_OPEN_BRACE = 56, TK_CLOSE_BRACE = 57,
+    TK_LESS_THAN = 58, TK_GREATER_THAN = 59, TK_EQUALS = 60, TK_GT_EQ = 61, TK_LT_EQ = 62,
+    TK_NOT_EQ_1 = 63, TK_NOT_EQ_2 = 64, TK_AT = 65, TK_ARROW = 66,
+    TK_ADD_ASSIGN = 67, TK_SUB_ASSIGN = 68, TK_MULT_ASSIGN = 69, TK_AT_ASSIGN = 70,
+    TK_DIV_ASSIGN = 71, TK_MOD_ASSIGN = 72, TK_AND_ASSIGN = 73, TK_OR_ASSIGN = 74,
+    TK_XOR_ASSIGN = 75, TK_LEFT_SHIFT_ASSIGN = 76, TK_RIGHT_SHIFT_ASSIGN = 77,
+    TK_POWER_ASSIGN = 78, TK_IDIV_ASSIGN = 79, TK_FORMAT_QUOTATION = 80, TK_QUOTATION = 81,
+    TK_UNKNOWN_CHAR = 83,
+};
+
+// Compact token record: a span into the source buffer plus its line. Tokens
+// synthesized for layout (INDENT, DEDENT, the NEWLINE at EOF) may be empty.
+struct TokenRecord {
+    TokenType type;
+    uint32_t line;   // 1-based
+    uint32_t begin;  // byte offset into the source
+    uint32_t length;
+};
+
+struct TokenBuffer {
+    std::string_view source;
+    std::vector<TokenRecord> tokens;   // always terminated by TK_EOF
+    std::vector<uint32_t> line_starts; // byte offset of every line start
+
+    std::string_view text(const TokenRecord& t) const { return source.substr(t.begin, t.length); }
+    uint32_t column(const TokenRecord& t) const { return t.begin - line_starts[t.line - 1]; }
+};
+
+// Hand-written replacement for the generated Python3Lexer. It produces the
+// same token stream (including INDENT/DEDENT, the f-string modes and the
+// NEWLINE suppression inside brackets) directly from a contiguous buffer.
+class NativeLexer {
+public:
+    explicit NativeLexer(std::string_view source);
+
+    TokenBuffer run();
+
+private:
+    std::string_view src_;
+    size_t pos_ = 0;
+    uint32_t line_ = 1;
+    TokenBuffer out_;
+
+    std::vector<int> indents_; // indentation stack (empty == column 0)
+    int opened_ = 0;           // open (, [, { not yet closed
+    int format_mode_ = 0;      // nesting depth of f"..."
+    bool expr_mode_ = false;   // inside {...} of the innermost f-string
+
+    int peek(size_t ahead = 0) const { return pos_ + ahead < src_.size() ? (unsigned char)src_[pos_ + ahead] : -1; }
+    void emit(TokenType type, size_t begin, size_t end, uint32_t line);
+    void emit(TokenType type, size_t begin, size_t end) { emit(type, begin, end, line_); }
+    void newLine(size_t at);
+
+    void lexNewline(bool at_start);
+    void lexFormatLiteral();
+    void lexName();
+    void lexNumber();
+    void lexString(size_t begin);
+    void lexOperator();
+    void finish();
+};
+
+#endif // PYTHON_INTERPRETER_NATIVE_LEXER_H
@@ -0,0 +1,326 @@
+#include "NativeParser.h"
+using namespace std;
+
+void NativeParser::fail(const char* what) const {
+    const TokenRecord& t = peek();
+    string near = t.type==TK_EOF ? "<EOF>" : string(buf_.text(t));
+    throw SyntaxError(t.line, string("expected ") + what + " near '" + near + "'");
+}
+
+const TokenRecord& NativeParser::expect(TokenType t, const char* what){
+    if (type()!=t) fail(what);
+    return buf_.tokens[pos_++];
+}
+
+bool NativeParser::startsTest() const {
+    switch (type()){
+        case TK_NAME: case TK_NUMBER: case TK_STRING: case TK_NONE: case TK_TRUE: case TK_FALSE:
+        case TK_OPEN_PAREN: case TK_FORMAT_QUOTATION: case TK_NOT: case TK_ADD: case TK_MINUS:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// file_input: (NEWLINE | stmt)* EOF
+Program NativeParser::parse(){
+    prog_.nodes.reserve(buf_.tokens.size());
+    vector<NodeId> stmts;
+    while (type()!=TK_EOF){
+        if (accept(TK_NEWLINE)) continue;
+        stmts.push_back(parseStmt());
+    }
+    prog_.root = prog_.add(NodeKind::Block, 1);
+    prog_.setList(prog_.root, stmts);
+    prog_.nodes.shrink_to_fit();
+    return std::move(prog_);
+}
+
+NodeId NativeParser::parseStmt(){
+    switch (type()){
+        case TK_IF: return parseIf();
+        case TK_WHILE: return parseWhile();
+        case TK_DEF: return parseFuncdef();
+        default: return parseSimpleStmt();
+    }
+}
+
+// simple_stmt: small_stmt NEWLINE; small_stmt: expr_stmt | flow_stmt
+NodeId NativeParser::parseSimpleStmt(){
+    uint32_t line = peek().line;
+    NodeId s;
+    if (accept(TK_BREAK)) s = prog_.add(NodeKind::Break, line);
+    else if (accept(TK_CONTINUE)) s = prog_.add(NodeKind::Continue, line);
+    else if (accept(TK_RETURN)) s = prog_.add(NodeKind::Return, line, type()==TK_NEWLINE ? NO_NODE : parseTestlist());
+    else s = parseExprStmt();
+    expect(TK_NEWLINE, "end of statement");
+    return s;
+}
+
+// expr_stmt: testlist ((augassign testlist) | ('=' testlist)*)
+NodeId NativeParser::parseExprStmt(){
+    uint32_t line = peek().line;
+    NodeId lhs = parseTestlist();
+    BinOp op;
+    switch (type()){
+        case TK_ADD_ASSIGN: op = BinOp::Add; break;
+        case TK_SUB_ASSIGN: op = BinOp::Sub; break;
+        case TK_MULT_ASSIGN: op = BinOp::Mul; break;
+        case TK_DIV_ASSIGN: op = BinOp::Div; break;
+        case TK_IDIV_ASSIGN: op = BinOp::FloorDiv; break;
+        case TK_MOD_ASSIGN: op = BinOp::Mod; break;
+        default: {
+            if (type()!=TK_ASSIGN) return prog_.add(NodeKind::ExprStmt, line, lhs);
+            vector<NodeId> parts{lhs};
+            while (accept(TK_ASSIGN)) parts.push_back(parseTestlist());
+            NodeId s = prog_.add(NodeKind::Assign, line);
+            prog_.setList(s, parts);
+            return s;
+        }
+    }
+    ++pos_;
+    NodeId rhs = parseTestlist();
+    return prog_.add(NodeKind::AugAssign, line, lhs, rhs, (uint8_t)op);
+}
+
+// if_stmt: 'if' test ':' suite ('elif' test ':' suite)* ('else' ':' suite)?
+NodeId NativeParser::parseIf(){
+    uint32_t line = expect(TK_IF, "'if'").line;
+    vector<NodeId> arms;
+    do {
+        arms.push_back(parseTest());
+        expect(TK_COLON, "':'");
+        arms.push_back(parseSuite());
+    } while (accept(TK_ELIF));
+    NodeId orelse = NO_NODE;
+    if (accept(TK_ELSE)){
+        expect(TK_COLON, "':'");
+        orelse = parseSuite();
+    }
+    NodeId s = prog_.add(NodeKind::If, line, NO_NODE, orelse);
+    prog_.setList(s, arms);
+    return s;
+}
+
+// while_stmt: 'while' test ':' suite
+NodeId NativeParser::parseWhile(){
+    uint32_t line = expect(TK_WHILE, "'while'").line;
+    NodeId cond = parseTest();
+    expect(TK_COLON, "':'");
+    NodeId body = parseSuite();
+    return prog_.add(NodeKind::While, line, cond, body);
+}
+
+// funcdef: 'def' NAME '(' typedargslist? ')' ':' suite
+// typedargslist: tfpdef ('=' test)? (',' tfpdef ('=' test)?)*
+NodeId NativeParser::parseFuncdef(){
+    uint32_t line = expect(TK_DEF, "'def'").line;
+    uint32_t name = prog_.addName(buf_.text(expect(TK_NAME, "function name")));
+    expect(TK_OPEN_PAREN, "'('");
+    vector<NodeId> params;
+    if (type()==TK_NAME){
+        do {
+            const TokenRecord& p = expect(TK_NAME, "parameter name");
+            NodeId def = accept(TK_ASSIGN) ? parseTest() : NO_NODE;
+            params.push_back(prog_.add(NodeKind::Param, p.line, prog_.addName(buf_.text(p)), def));
+        } while (accept(TK_COMMA));
+    }
+    expect(TK_CLOSE_PAREN, "')'");
+    expect(TK_COLON, "':'");
+    NodeId body = parseSuite();
+    NodeId s = prog_.add(NodeKind::FuncDef, line, name, body);
+    prog_.setList(s, params);
+    return s;
+}
+
+// suite: simple_stmt | NEWLINE INDENT stmt+ DEDENT
+NodeId NativeParser::parseSuite(){
+    uint32_t line = peek().line;
+    vector<NodeId> stmts;
+    if (accept(TK_NEWLINE)){
+        expect(TK_INDENT, "indented block");
+        do stmts.push_back(parseStmt()); while (!accept(TK_DEDENT));
+    }else{
+        stmts.push_back(parseSimpleStmt());
+    }
+    NodeId s = prog_.add(NodeKind::Block, line);
+    prog_.setList(s, stmts);
+    return s;
+}
+
+// testlist: test (',' test)* (',')?
+NodeId NativeParser::parseTestlist(){
+    uint32_t line = peek().line;
+    NodeId first = parseTest();
+    if (type()!=TK_COMMA) return first;
+    vector<NodeId> items{first};
+    while (accept(TK_COMMA) && startsTest()) items.push_back(parseTest());
+    NodeId t = prog_.add(NodeKind::Tuple, line);
+    prog_.setList(t, items);
+    return t;
+}
+
+// test: or_test; or_test: and_test ('or' and_test)*
+NodeId NativeParser::parseTest(){
+    uint32_t line = peek().line;
+    NodeId first = parseAndTest();
+    if (type()!=TK_OR) return first;
+    vector<NodeId> items{first};
+    while (accept(TK_OR)) items.push_back(parseAndTest());
+    NodeId t = prog_.add(NodeKind::Or, line);
+    prog_.setList(t, items);
+    return t;
+}
+
+// and_test: not_test ('and' not_test)*
+NodeId NativeParser::parseAndTest(){
+    uint32_t line = peek().line;
+    NodeId first = parseNotTest();
+    if (type()!=TK_AND) return first;
+    vector<NodeId> items{first};
+    while (accept(TK_AND)) items.push_back(parseNotTest());
+    NodeId t = prog_.add(NodeKind::And, line);
+    prog_.setList(t, items);
+    return t;
+}
+
+// not_test: 'not' not_test | comparison
+NodeId NativeParser::parseNotTest(){
+    uint32_t line = peek().line;
+    if (accept(TK_NOT)) return prog_.add(NodeKind::Not, line, parseNotTest());
+    return parseComparison();
+}
+
+// comparison: arith_expr (comp_op arith_expr)*
+NodeId NativeParser::parseComparison(){
+    uint32_t line = peek().line;
+    NodeId first = parseArith(1);
+    vector<NodeId> items{first};
+    for (;;){
+        CmpOp op;
+        switch (type()){
+            case TK_LESS_THAN: op = CmpOp::Lt; break;
+            case TK_GREATER_THAN: op = CmpOp::Gt; break;
+            case TK_EQUALS: op = CmpOp::Eq; break;
+            case TK_GT_EQ: op = CmpOp::Ge; break;
+            case TK_LT_EQ: op = CmpOp::Le; break;
+            case TK_NOT_EQ_2: op = CmpOp::Ne; break;
+            default: goto done;
+        }
+        ++pos_;
+        items.push_back((NodeId)op);
+        items.push_back(parseArith(1));
+    }
+done:
+    if (items.size()==1) return first;
+    NodeId t = prog_.add(NodeKind::Compare, line);
+    prog_.setList(t, items);
+    return t;
+}
+
+// arith_expr: term (addorsub_op term)*; term: factor (muldivmod_op factor)*
+NodeId NativeParser::parseArith(int min_prec){
+    NodeId lhs = parseFactor();
+    for (;;){
+        int prec; BinOp op;
+        switch (type()){
+            case TK_ADD: prec = 1; op = BinOp::Add; break;
+            case TK_MINUS: prec = 1; op = BinOp::Sub; break;
+            case TK_STAR: prec = 2; op = BinOp::Mul; break;
+            case TK_DIV: prec = 2; op = BinOp::Div; break;
+            case TK_IDIV: prec = 2; op = BinOp::FloorDiv; break;
+            case TK_MOD: prec = 2; op = BinOp::Mod; break;
+            default: return lhs;
+        }
+        if (prec < min_prec) return lhs;
+        uint32_t line = peek().line;
+        ++pos_;
+        NodeId rhs = parseArith(prec + 1);
+        lhs = prog_.add(NodeKind::Binary, line, lhs, rhs, (uint8_t)op);
+    }
+}
+
+// factor: ('+'|'-') factor | atom_expr
+NodeId NativeParser::parseFactor(){
+    uint32_t line = peek().line;
+    if (accept(TK_ADD)) return prog_.add(NodeKind::Unary, line, parseFactor(), NO_NODE, (uint8_t)UnaryOp::Pos);
+    if (accept(TK_MINUS)) return prog_.add(NodeKind::Unary, line, parseFactor(), NO_NODE, (uint8_t)UnaryOp::Neg);
+    return parseAtomExpr();
+}
+
+// atom_expr: atom trailer?; trailer: '(' arglist? ')'
+// arglist: argument (',' argument)* (',')?; argument: test | test '=' test
+NodeId NativeParser::parseAtomExpr(){
+    uint32_t line = peek().line;
+    NodeId atom = parseAtom();
+    if (!accept(TK_OPEN_PAREN)) return atom;
+    vector<NodeId> args;
+    while (type()!=TK_CLOSE_PAREN){
+        uint32_t arg_line = peek().line;
+        NodeId arg = parseTest();
+        if (accept(TK_ASSIGN)){
+            uint32_t key = prog_[arg].kind==NodeKind::Name ? prog_[arg].a : NO_NODE;
+            arg = prog_.add(NodeKind::Keyword, arg_line, key, parseTest());
+        }
+        args.push_back(arg);
+        if (!accept(TK_COMMA)) break;
+    }
+    expect(TK_CLOSE_PAREN, "')'");
+    bool named = prog_[atom].kind==NodeKind::Name;
+    NodeId call = prog_.add(NodeKind::Call, line, named ? prog_[atom].a : NO_NODE, named ? NO_NODE : atom);
+    prog_.setList(call, args);
+    return call;
+}
+
+// atom: NAME | NUMBER | STRING+ | 'None' | 'True' | 'False' | '(' test ')' | format_string
+NodeId NativeParser::parseAtom(){
+    const TokenRecord& t = peek();
+    switch (t.type){
+        case TK_NAME:
+            ++pos_;
+            return prog_.add(NodeKind::Name, t.line, prog_.addName(buf_.text(t)));
+        case TK_NUMBER:
+            ++pos_;
+            return prog_.add(NodeKind::Const, t.line, prog_.addConstant(parseNumber(string(buf_.text(t)))));
+        case TK_STRING: {
+            string out;
+            while (type()==TK_STRING) out += parseStringToken(string(buf_.text(buf_.tokens[pos_++])));
+            return prog_.add(NodeKind::Const, t.line, prog_.addConstant(Value::fromStr(std::move(out))));
+        }
+        case TK_NONE: ++pos_; return prog_.add(NodeKind::Const, t.line, prog_.addConstant(Value::None()));
+        case TK_TRUE: ++pos_; return prog_.add(NodeKind::Const, t.line, prog_.addConstant(Value::fromBool(true)));
+        case TK_FALSE: ++pos_; return prog_.add(NodeKind::Const, t.line, prog_.addConstant(Value::fromBool(false)));
+        case TK_OPEN_PAREN: {
+            ++pos_;
+            NodeId inner = parseTest();
+            expect(TK_CLOSE_PAREN, "')'");
+            return inner;
+        }
+        case TK_FORMAT_QUOTATION:
+            return parseFormatString();
+        default:
+            fail("expression");
+    }
+}
+
+// format_string: FORMAT_QUOTATION (FORMAT_STRING_LITERAL | '{' testlist '}')* QUOTATION
+NodeId NativeParser::parseFormatString(){
+    uint32_t line = expect(TK_FORMAT_QUOTATION, "f-string").line;
+    vector<NodeId> parts;
+    for (;;){
+        const TokenRecord& t = peek();
+        if (accept(TK_QUOTATION)) break;
+        if (accept(TK_FORMAT_STRING_LITERAL)){
+            string frag = parseFormatLiteral(string(buf_.text(t)));
+            parts.push_back(prog_.add(NodeKind::Const, t.line, prog_.addConstant(Value::fromStr(std::move(frag)))));
+        }else if (accept(TK_OPEN_BRACE)){
+            parts.push_back(parseTestlist());
+            expect(TK_CLOSE_BRACE, "'}'");
+        }else{
+            fail("end of f-string");
+        }
+    }
+    NodeId f = prog_.add(NodeKind::FString, line);
+    prog_.setList(f, parts);
+    return f;
+}
@@ -0,0 +1,54 @@
+#pragma once
+#ifndef PYTHON_INTERPRETER_NATIVE_PARSER_H
+#define PYTHON_INTERPRETER_NATIVE_PARSER_H
+
+#include "Ast.h"
+#include "NativeLexer.h"
+
+struct SyntaxError : std::runtime_error {
+    uint32_t line;
+    SyntaxError(uint32_t line, const std::string& msg)
+        : std::runtime_error("line " + std::to_string(line) + ": " + msg), line(line) {}
+};
+
+// Recursive-descent parser for resources/Python3Parser.g4. Binary operators
+// are handled by precedence climbing; the result is an arena Program.
+class NativeParser {
+public:
+    explicit NativeParser(const TokenBuffer& buffer) : buf_(buffer) {}
+
+    Program parse();
+
+private:
+    const TokenBuffer& buf_;
+    size_t pos_ = 0;
+    Program prog_;
+
+    const TokenRecord& peek() const { return buf_.tokens[pos_]; }
+    TokenType type() const { return buf_.tokens[pos_].type; }
+    bool accept(TokenType t){ if (type()==t){ ++pos_; return true; } return false; }
+    const TokenRecord& expect(TokenType t, const char* what);
+    [[noreturn]] void fail(const char* what) const;
+    bool startsTest() const;
+
+    NodeId parseStmt();
+    NodeId parseSimpleStmt();
+    NodeId parseExprStmt();
+    NodeId parseIf();
+    NodeId parseWhile();
+    NodeId parseFuncdef();
+    NodeId parseSuite();
+
+    NodeId parseTestlist();
+    NodeId parseTest();
+    NodeId parseAndTest();
+    NodeId parseNotTest();
+    NodeId parseComparison();
+    NodeId parseArith(int min_prec);
+    NodeId parseFactor();
+    NodeId parseAtomExpr();
+    NodeId parseAtom();
+    NodeId parseFormatString();
+};
+
+#endif // PYTHON_INTERPRETER_NATIVE_PARSER_H
@@ -0,0 +1,36 @@
+#include "NativeTokenSource.h"
+#include "Python3Lexer.h"
+using namespace std;
+
+static constexpr bool sameId(TokenType native, size_t generated){ return (size_t)native == generated; }
+static_assert(sameId(TK_INDENT, Python3Lexer::INDENT) && sameId(TK_DEDENT, Python3Lexer::DEDENT) &&
+              sameId(TK_STRING, Python3Lexer::STRING) && sameId(TK_NUMBER, Python3Lexer::NUMBER) &&
+              sameId(TK_NEWLINE, Python3Lexer::NEWLINE) && sameId(TK_NAME, Python3Lexer::NAME) &&
+              sameId(TK_FORMAT_STRING_LITERAL, Python3Lexer::FORMAT_STRING_LITERAL) &&
+              sameId(TK_IDIV_ASSIGN, Python3Lexer::IDIV_ASSIGN) && sameId(TK_FORMAT_QUOTATION, Python3Lexer::FORMAT_QUOTATION) &&
+              sameId(TK_QUOTATION, Python3Lexer::QUOTATION) && sameId(TK_UNKNOWN_CHAR, Python3Lexer::UNKNOWN_CHAR),
+              "native token ids must match Python3Lexer");
+
+unique_ptr<antlr4::Token> NativeTokenSource::nextToken(){
+    const TokenRecord& t = buffer_.tokens[next_];
+    if (t.type != TK_EOF) ++next_;
+    size_t type = t.type == TK_EOF ? (size_t)antlr4::Token::EOF : (size_t)t.type;
+    auto tok = make_unique<antlr4::CommonToken>(make_pair(this, (antlr4::CharStream*)nullptr), type,
+                                                antlr4::Token::DEFAULT_CHANNEL, t.begin, t.begin + t.length - 1);
+    tok->setText(t.type == TK_EOF ? string("<EOF>") : string(buffer_.text(t)));
+    tok->setLine(t.line);
+    tok->setCharPositionInLine(buffer_.column(t));
+    return tok;
+}
+
+size_t NativeTokenSource::getLine() const {
+    return buffer_.tokens[next_].line;
+}
+
+size_t NativeTokenSource::getCharPositionInLine(){
+    return buffer_.column(buffer_.tokens[next_]);
+}
+
+antlr4::TokenFactory<antlr4::CommonToken>* NativeTokenSource::getTokenFactory(){
+    return antlr4::CommonTokenFactory::DEFAULT.get();
+}
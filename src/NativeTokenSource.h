@@ -0,0 +1,27 @@
+#pragma once
+#ifndef PYTHON_INTERPRETER_NATIVE_TOKEN_SOURCE_H
+#define PYTHON_INTERPRETER_NATIVE_TOKEN_SOURCE_H
+
+#include "NativeLexer.h"
+#include "antlr4-runtime.h"
+
+// Feeds records produced by the native Lexer to the ANTLR parser, building
+// a heap CommonToken from each record as the token stream pulls it (the
+// ANTLR front end fills its stream up front, so every record becomes one).
+class NativeTokenSource : public antlr4::TokenSource {
+public:
+    explicit NativeTokenSource(const TokenBuffer& buffer) : buffer_(buffer) {}
+
+    std::unique_ptr<antlr4::Token> nextToken() override;
+    size_t getLine() const override;
+    size_t getCharPositionInLine() override;
+    antlr4::CharStream* getInputStream() override { return nullptr; }
+    std::string getSourceName() override { return "<stdin>"; }
+    antlr4::TokenFactory<antlr4::CommonToken>* getTokenFactory() override;
+
+private:
+    const TokenBuffer& buffer_;
+    size_t next_ = 0;
+};
+
+#endif // PYTHON_INTERPRETER_NATIVE_TOKEN_SOURCE_H
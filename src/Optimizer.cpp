@@ -0,0 +1,129 @@
+#include "Optimizer.h"
+#include "Interpreter.h"
+using namespace std;
+
+// folded string constants larger than this stay as run-time work
+static constexpr size_t MAX_FOLDED_STRING = 4096;
+
+void Optimizer::run(){
+    if (prog_.root!=NO_NODE) visit(prog_.root);
+}
+
+// Post-order walk: children are simplified before their parent looks at them.
+// The node array never grows here, so the reference n stays valid.
+void Optimizer::visit(NodeId id){
+    Node& n = prog_.nodes[id];
+    switch (n.kind){
+        case NodeKind::Const: case NodeKind::Name:
+        case NodeKind::Break: case NodeKind::Continue:
+            return;
+        case NodeKind::Compare:
+            // odd list slots are CmpOp values, not nodes
+            for (uint32_t i = 0; i < n.count; i += 2) visit(prog_.child(n, i));
+            return;
+        case NodeKind::Unary:
+            visit(n.a);
+            foldUnary(id);
+            return;
+        case NodeKind::Not:
+            visit(n.a);
+            if (isConst(n.a)) makeConst(id, Value::fromBool(!isTruthy(constant(n.a))));
+            return;
+        case NodeKind::Binary:
+            visit(n.a);
+            visit(n.b);
+            foldBinary(id);
+            return;
+        case NodeKind::FString:
+            for (uint32_t i = 0; i < n.count; ++i) visit(prog_.child(n, i));
+            foldFString(id);
+            return;
+        case NodeKind::AugAssign:
+            visit(n.b);
+            reduceStrength(id);
+            return;
+        case NodeKind::Call: case NodeKind::Keyword: case NodeKind::FuncDef: case NodeKind::Param:
+            // a holds a name index here, b an optional expression
+            if (n.b!=NO_NODE) visit(n.b);
+            for (uint32_t i = 0; i < n.count; ++i) visit(prog_.child(n, i));
+            return;
+        default: {
+            // remaining kinds: a, b and the child list are all node ids
+            if (n.a!=NO_NODE) visit(n.a);
+            if (n.b!=NO_NODE) visit(n.b);
+            for (uint32_t i = 0; i < n.count; ++i) visit(prog_.child(n, i));
+            return;
+        }
+    }
+}
+
+void Optimizer::makeConst(NodeId id, Value v){
+    Node& n = prog_.nodes[id];
+    n.kind = NodeKind::Const;
+    n.op = 0;
+    n.a = prog_.addConstant(std::move(v));
+    n.b = NO_NODE;
+    n.first = n.count = 0;
+}
+
+void Optimizer::foldUnary(NodeId id){
+    const Node& n = prog_[id];
+    if (!isConst(n.a)) return;
+    Value v;
+    try {
+        v = Interpreter::unary((UnaryOp)n.op, constant(n.a));
+    }catch (const exception&){
+        return; // raised at run time instead, after what runs before it
+    }
+    makeConst(id, std::move(v));
+}
+
+void Optimizer::foldBinary(NodeId id){
+    const Node n = prog_[id];
+    BinOp op = (BinOp)n.op;
+    if (isConst(n.a) && isConst(n.b)){
+        const Value& lhs = constant(n.a);
+        const Value& rhs = constant(n.b);
+        // division by zero keeps failing (or producing inf) at run time, where it belongs
+        bool divides = op==BinOp::Div || op==BinOp::FloorDiv || op==BinOp::Mod;
+        if (divides && !isTruthy(rhs)) return;
+        if (op==BinOp::Mul && (lhs.type==Value::Type::STR || rhs.type==Value::Type::STR)){
+            const Value& str = lhs.type==Value::Type::STR ? lhs : rhs;
+            const Value& times = lhs.type==Value::Type::STR ? rhs : lhs;
+            if (times.type==Value::Type::INT && times.i > (long long)(MAX_FOLDED_STRING / max<size_t>(str.s.size(), 1))) return;
+        }
+        Value v;
+        try {
+            v = Interpreter::binary(op, lhs, rhs);
+        }catch (const exception&){
+            return; // as for unary: 1.0e400 // 1 fails when it runs
+        }
+        if (v.type==Value::Type::STR && v.s.size() > MAX_FOLDED_STRING) return;
+        makeConst(id, std::move(v));
+        return;
+    }
+    reduceStrength(id);
+}
+
+void Optimizer::reduceStrength(NodeId id){
+    Node& n = prog_.nodes[id];
+    BinOp op = (BinOp)n.op;
+    if ((op!=BinOp::FloorDiv && op!=BinOp::Mod) || !isConst(n.b)) return;
+    const Value& d = constant(n.b);
+    if (d.type!=Value::Type::INT || d.i <= 0 || (d.i & (d.i - 1)) != 0) return;
+    unsigned k = boost::multiprecision::msb(d.i);
+    if (k >= 64) return;
+    n.op = (uint8_t)(op==BinOp::FloorDiv ? BinOp::FloorDivPow2 : BinOp::ModPow2);
+    n.first = k;
+}
+
+void Optimizer::foldFString(NodeId id){
+    const Node& n = prog_[id];
+    string out;
+    for (uint32_t i = 0; i < n.count; ++i){
+        NodeId part = prog_.child(n, i);
+        if (!isConst(part)) return;
+        out += toString(constant(part));
+    }
+    makeConst(id, Value::fromStr(std::move(out)));
+}
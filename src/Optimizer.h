@@ -0,0 +1,33 @@
+#pragma once
+#ifndef PYTHON_INTERPRETER_OPTIMIZER_H
+#define PYTHON_INTERPRETER_OPTIMIZER_H
+
+#include "Ast.h"
+
+// Rewrites a parsed Program in place before it runs. Nodes are only ever
+// overwritten (never removed), so NodeIds held elsewhere stay valid.
+//  - constant subexpressions are folded with the interpreter's own operator
+//    code, so results (bignums, float formatting, floor rounding) are exact;
+//  - // and % (also //= and %=) by a constant 2**k become FloorDivPow2 and
+//    ModPow2, which shift or mask ints and keep the general path otherwise.
+// Identities such as x + 0 need x's type, so the Compiler handles them.
+class Optimizer {
+public:
+    explicit Optimizer(Program& program) : prog_(program) {}
+
+    void run();
+
+private:
+    Program& prog_;
+
+    void visit(NodeId id);
+    void foldUnary(NodeId id);
+    void foldBinary(NodeId id);
+    void foldFString(NodeId id);
+    void reduceStrength(NodeId id);
+    void makeConst(NodeId id, Value v);
+    bool isConst(NodeId id) const { return prog_[id].kind==NodeKind::Const; }
+    const Value& constant(NodeId id) const { return prog_.constants[prog_[id].a]; }
+};
+
+#endif // PYTHON_INTERPRETER_OPTIMIZER_H
@@ -0,0 +1,81 @@
+#include "Profiler.h"
+#include <sys/time.h>
+using namespace std;
+
+volatile sig_atomic_t Profiler::pending_ = 0;
+
+void Profiler::onTick(int){
+    pending_ = pending_ + 1;
+}
+
+void Profiler::start(){
+    struct sigaction sa{};
+    sa.sa_handler = onTick;
+    sa.sa_flags = SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGPROF, &sa, nullptr);
+    itimerval timer{};
+    timer.it_interval.tv_usec = INTERVAL_US;
+    timer.it_value.tv_usec = INTERVAL_US;
+    setitimer(ITIMER_PROF, &timer, nullptr);
+    running_ = true;
+}
+
+void Profiler::stop(){
+    if (!running_) return;
+    itimerval timer{};
+    setitimer(ITIMER_PROF, &timer, nullptr);
+    signal(SIGPROF, SIG_IGN);
+    running_ = false;
+}
+
+string Profiler::frameName(const Frame& f) const{
+    return (f.fn==NO_NODE ? string("<module>") : prog_.names[f.fn]) + ":" + to_string(f.line);
+}
+
+void Profiler::sample(const Frame* frames, size_t n){
+    uint64_t ticks = (uint64_t)pending_;
+    pending_ = 0;
+    if (!ticks || !n) return;
+    samples_ += ticks;
+
+    string stack;
+    for (size_t i = 0; i < n; ++i){
+        if (i) stack += ';';
+        stack += frameName(frames[i]);
+    }
+    stacks_[stack] += ticks;
+
+    // recursion puts a line on the stack many times; its total counts it once
+    seen_.clear();
+    for (size_t i = 0; i < n; ++i){
+        uint32_t line = frames[i].line;
+        if (find(seen_.begin(), seen_.end(), line)!=seen_.end()) continue;
+        seen_.push_back(line);
+        LineCount& c = lines_[line];
+        c.fn = frames[i].fn;
+        c.total += ticks;
+    }
+    lines_[frames[n - 1].line].self += ticks;
+}
+
+void Profiler::writeFolded(ostream& out) const{
+    for (const auto& [stack, count] : stacks_) out << stack << ' ' << count << '\n';
+}
+
+void Profiler::writeLineTable(ostream& out) const{
+    vector<pair<uint32_t, LineCount>> rows(lines_.begin(), lines_.end());
+    stable_sort(rows.begin(), rows.end(), [](const auto& a, const auto& b){
+        return a.second.self!=b.second.self ? a.second.self > b.second.self : a.second.total > b.second.total;
+    });
+    char buf[128];
+    snprintf(buf, sizeof buf, "profile: %llu samples every %ldus\n", (unsigned long long)samples_, INTERVAL_US);
+    out << buf;
+    if (!samples_) return;
+    out << "    line    self%   total%  function\n";
+    for (const auto& [line, c] : rows){
+        snprintf(buf, sizeof buf, "%8u  %6.2f%%  %6.2f%%  %s\n", line, 100.0 * c.self / samples_,
+                 100.0 * c.total / samples_, c.fn==NO_NODE ? "<module>" : prog_.names[c.fn].c_str());
+        out << buf;
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+#ifndef PYTHON_INTERPRETER_PROFILER_H
+#define PYTHON_INTERPRETER_PROFILER_H
+
+#include "Ast.h"
+#include <csignal>
+
+// Statistical profiler of script lines (--profile). A CPU-time timer raises
+// SIGPROF every INTERVAL_US; the handler only counts the tick, and the
+// running engine takes the sample at its next statement (tree walker) or
+// instruction (VM) by handing over its call stack, so a sample never sees a
+// half-updated stack.
+class Profiler {
+public:
+    static constexpr long INTERVAL_US = 1000;
+
+    // one call stack entry; fn is the def symbol, NO_NODE for the module
+    struct Frame {
+        uint32_t fn;
+        uint32_t line;
+    };
+
+    explicit Profiler(const Program& program) : prog_(program) {}
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+    ~Profiler() { stop(); }
+
+    void start();
+    void stop();
+
+    static bool due() { return pending_ != 0; }
+    // counts frames[0..n) (outermost first) once for every tick since the last sample
+    void sample(const Frame* frames, size_t n);
+
+    // "<module>:3;fib:9;fib:9 42" lines, for flamegraph.pl and friends
+    void writeFolded(std::ostream& out) const;
+    // lines by self samples, with the samples of everything they called
+    void writeLineTable(std::ostream& out) const;
+
+private:
+    struct LineCount {
+        uint32_t fn = NO_NODE;
+        uint64_t self = 0;
+        uint64_t total = 0;
+    };
+
+    static volatile std::sig_atomic_t pending_;
+    static void onTick(int);
+
+    const Program& prog_;
+    bool running_ = false;
+    uint64_t samples_ = 0;
+    std::map<std::string, uint64_t> stacks_;   // folded stack -> samples
+    std::map<uint32_t, LineCount> lines_;       // line -> counts
+    std::vector<uint32_t> seen_;                // scratch: lines already counted in this sample
+
+    std::string frameName(const Frame& f) const;
+};
+
+#endif // PYTHON_INTERPRETER_PROFILER_H
@@ -0,0 +1,65 @@
+#include "SourceFile.h"
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+using namespace std;
+
+SourceFile SourceFile::open(const string& path){
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) throw runtime_error("cannot open " + path + ": " + strerror(errno));
+    try{
+        SourceFile f = fromDescriptor(fd, path);
+        ::close(fd);
+        return f;
+    }catch(...){
+        ::close(fd);
+        throw;
+    }
+}
+
+SourceFile SourceFile::fromStdin(){
+    return fromDescriptor(STDIN_FILENO, "<stdin>");
+}
+
+SourceFile SourceFile::fromDescriptor(int fd, const string& name){
+    SourceFile f;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0){
+        off_t at = lseek(fd, 0, SEEK_CUR);
+        void* p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED){
+            madvise(p, (size_t)st.st_size, MADV_SEQUENTIAL);
+            f.data_ = static_cast<const char*>(p);
+            f.size_ = f.map_size_ = (size_t)st.st_size;
+            f.offset_ = (at > 0 && at <= st.st_size) ? (size_t)at : 0;
+            return f;
+        }
+    }
+    // pipe, terminal or unmappable file: read it
+    char chunk[1 << 16];
+    for (;;){
+        ssize_t n = ::read(fd, chunk, sizeof chunk);
+        if (n > 0){ f.owned_.append(chunk, (size_t)n); continue; }
+        if (n == 0) break;
+        if (errno == EINTR) continue;
+        throw runtime_error("cannot read " + name + ": " + strerror(errno));
+    }
+    f.data_ = f.owned_.data();
+    f.size_ = f.owned_.size();
+    return f;
+}
+
+SourceFile::SourceFile(SourceFile&& other) noexcept
+    : data_(other.data_), size_(other.size_), offset_(other.offset_), map_size_(other.map_size_),
+      owned_(std::move(other.owned_)){
+    if (!map_size_) data_ = owned_.data();
+    other.data_ = nullptr; other.size_ = other.offset_ = other.map_size_ = 0;
+}
+
+SourceFile::~SourceFile(){
+    if (map_size_) munmap(const_cast<char*>(data_), map_size_);
+}
@@ -0,0 +1,35 @@
+#pragma once
+#ifndef PYTHON_INTERPRETER_SOURCE_FILE_H
+#define PYTHON_INTERPRETER_SOURCE_FILE_H
+
+#include <string>
+#include <string_view>
+
+// Script text as one contiguous read-only buffer. Regular files (including a
+// regular file redirected to stdin) are mmap'ed and lexed in place; pipes and
+// terminals fall back to reading into an owned string.
+class SourceFile {
+public:
+    static SourceFile open(const std::string& path);
+    static SourceFile fromStdin();
+
+    SourceFile(SourceFile&& other) noexcept;
+    SourceFile& operator=(SourceFile&&) = delete;
+    SourceFile(const SourceFile&) = delete;
+    ~SourceFile();
+
+    std::string_view text() const { return {data_ + offset_, size_ - offset_}; }
+    bool mapped() const { return map_size_ != 0; }
+
+private:
+    SourceFile() = default;
+    static SourceFile fromDescriptor(int fd, const std::string& name);
+
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    size_t offset_ = 0;   // bytes of a mapping already consumed before we got the fd
+    size_t map_size_ = 0; // non-zero iff data_ is an mmap'ed region
+    std::string owned_;
+};
+
+#endif // PYTHON_INTERPRETER_SOURCE_FILE_H
@@ -0,0 +1,125 @@
+#include "Stats.h"
+using namespace std;
+
+static const char* const OP_NAMES[] = {"add", "sub", "mul", "floordiv", "mod"};
+
+static double ms(Stats::Clock::duration d){
+    return chrono::duration<double, milli>(d).count();
+}
+
+Stats::Stats(const Program& program) : prog_(program), start_(Clock::now()), last_(start_){
+    functions_[MODULE].calls = 1;
+}
+
+string Stats::fnName(uint32_t fn) const{
+    return fn==MODULE ? "<module>" : prog_.names[fn];
+}
+
+void Stats::charge(Clock::time_point now){
+    Clock::duration d = now - last_;
+    last_ = now;
+    if (line_!=NO_LINE) lines_[line_].self += d;
+    functions_[fn_].self += d;
+}
+
+void Stats::line(uint32_t line){
+    if (line==line_) return;
+    charge(Clock::now());
+    line_ = line;
+    LineCount& c = lines_[line];
+    ++c.count;
+    c.fn = fn_;
+    ++events_;
+}
+
+void Stats::enter(uint32_t fn){
+    Clock::time_point now = Clock::now();
+    charge(now);
+    calls_.push_back({fn_, line_, now});
+    FunctionCount& f = functions_[fn];
+    ++f.calls;
+    ++f.active;
+    fn_ = fn;
+    line_ = NO_LINE;
+}
+
+void Stats::leave(){
+    if (calls_.empty()) return;
+    Clock::time_point now = Clock::now();
+    charge(now);
+    CallRecord call = calls_.back();
+    calls_.pop_back();
+    FunctionCount& f = functions_[fn_];
+    if (--f.active==0) f.total += now - call.start;
+    fn_ = call.fn;
+    line_ = call.line;
+}
+
+void Stats::binary(BinOp op, const Value& lhs, const Value& rhs){
+    if (lhs.type!=Value::Type::INT || rhs.type!=Value::Type::INT) return;
+    int index;
+    switch (op){
+        case BinOp::Add: index = 0; break;
+        case BinOp::Sub: index = 1; break;
+        case BinOp::Mul: index = 2; break;
+        case BinOp::FloorDiv: case BinOp::FloorDivPow2: index = 3; break;
+        case BinOp::Mod: case BinOp::ModPow2: index = 4; break;
+        default: return;
+    }
+    size_t limbs = max(lhs.i.backend().size(), rhs.i.backend().size());
+    int bucket = 0;
+    for (size_t cap = 1; bucket + 1 < SIZE_BUCKETS && limbs > cap; cap *= 4) ++bucket;
+    OpCount& c = ops_[index];
+    ++c.count;
+    ++c.buckets[bucket];
+    c.max_limbs = max(c.max_limbs, limbs);
+}
+
+void Stats::finish(){
+    Clock::time_point now = Clock::now();
+    charge(now);
+    // a runtime error can leave calls open
+    while (!calls_.empty()) leave();
+    functions_[MODULE].total = now - start_;
+}
+
+void Stats::report(ostream& out) const{
+    char buf[160];
+    snprintf(buf, sizeof buf, "stats: %.3f ms, %llu line events\n", ms(last_ - start_), (unsigned long long)events_);
+    out << buf;
+
+    vector<pair<uint32_t, FunctionCount>> fns(functions_.begin(), functions_.end());
+    sort(fns.begin(), fns.end(), [](const auto& a, const auto& b){ return a.second.total > b.second.total; });
+    out << "function                  calls    total ms     self ms\n";
+    for (const auto& [fn, c] : fns){
+        snprintf(buf, sizeof buf, "%-20s %10llu %11.3f %11.3f\n", fnName(fn).c_str(), (unsigned long long)c.calls,
+                 ms(c.total), ms(c.self));
+        out << buf;
+    }
+
+    vector<pair<uint32_t, LineCount>> rows(lines_.begin(), lines_.end());
+    sort(rows.begin(), rows.end(), [](const auto& a, const auto& b){ return a.second.self > b.second.self; });
+    if (rows.size() > LINE_ROWS) rows.resize(LINE_ROWS);
+    out << "    line       count     self ms  function\n";
+    for (const auto& [line, c] : rows){
+        snprintf(buf, sizeof buf, "%8u %11llu %11.3f  %s\n", line, (unsigned long long)c.count, ms(c.self),
+                 fnName(c.fn).c_str());
+        out << buf;
+    }
+
+    snprintf(buf, sizeof buf, "%-9s %11s  limbs:%10s%10s%10s%10s%10s%10s%10s %10s\n", "int op", "count",
+             "1", "<=4", "<=16", "<=64", "<=256", "<=1024", "more", "max bits");
+    out << buf;
+    for (int i = 0; i < 5; ++i){
+        const OpCount& c = ops_[i];
+        if (!c.count) continue;
+        snprintf(buf, sizeof buf, "%-9s %11llu", OP_NAMES[i], (unsigned long long)c.count);
+        out << buf << "        ";
+        for (uint64_t n : c.buckets){
+            snprintf(buf, sizeof buf, "%10llu", (unsigned long long)n);
+            out << buf;
+        }
+        snprintf(buf, sizeof buf, " %10zu\n", c.max_limbs * 64);
+        out << buf;
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+#ifndef PYTHON_INTERPRETER_STATS_H
+#define PYTHON_INTERPRETER_STATS_H
+
+#include "Ast.h"
+#include <chrono>
+
+// Execution counters (--stats): how often each source line and user function
+// ran and the time spent in it, and the operand sizes of the int add, sub,
+// mul, floordiv and mod that went through the engine. Engines only call in
+// when they were given a Stats, so an ordinary run pays nothing.
+//
+// Time is charged between line events: the time from one event to the next
+// belongs to the earlier line and to the function running it (self time).
+// A function's total time spans its outermost active call.
+class Stats {
+public:
+    using Clock = std::chrono::steady_clock;
+    // operand size buckets, by limbs of the larger operand: 1, 4, 16, ... 1024, more
+    static constexpr int SIZE_BUCKETS = 7;
+    static constexpr size_t LINE_ROWS = 20; // lines shown in the report
+
+    explicit Stats(const Program& program);
+
+    // the engine moved to line; moving within the same line is not a new event
+    void line(uint32_t line);
+    // a call of the def fn starts / returns; calls nest
+    void enter(uint32_t fn);
+    void leave();
+    // counts op if both operands are ints
+    void binary(BinOp op, const Value& lhs, const Value& rhs);
+
+    // charges the time since the last event; call once the script stops
+    void finish();
+    void report(std::ostream& out) const;
+
+private:
+    static constexpr uint32_t MODULE = NO_NODE;
+    static constexpr uint32_t NO_LINE = NO_NODE;
+
+    struct LineCount {
+        uint64_t count = 0;
+        Clock::duration self{};
+        uint32_t fn = MODULE;
+    };
+    struct FunctionCount {
+        uint64_t calls = 0;
+        uint32_t active = 0; // recursion depth, so total counts the outermost call only
+        Clock::duration self{};
+        Clock::duration total{};
+    };
+    struct CallRecord {
+        uint32_t fn;
+        uint32_t line;      // caller's line, resumed on return
+        Clock::time_point start;
+    };
+    struct OpCount {
+        uint64_t count = 0;
+        uint64_t buckets[SIZE_BUCKETS] = {};
+        size_t max_limbs = 0;
+    };
+
+    const Program& prog_;
+    Clock::time_point start_, last_;
+    uint32_t line_ = NO_LINE;
+    uint32_t fn_ = MODULE;
+    uint64_t events_ = 0;
+    std::unordered_map<uint32_t, LineCount> lines_;
+    std::unordered_map<uint32_t, FunctionCount> functions_;
+    std::vector<CallRecord> calls_;
+    OpCount ops_[5]; // add, sub, mul, floordiv, mod
+
+    void charge(Clock::time_point now);
+    std::string fnName(uint32_t fn) const;
+};
+
+#endif // PYTHON_INTERPRETER_STATS_H
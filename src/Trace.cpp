@@ -0,0 +1,78 @@
+#include "Trace.h"
+using namespace std;
+
+Trace::Trace(const Program& program) : prog_(program), ring_(CAPACITY), start_(Clock::now()) {}
+
+uint64_t Trace::now() const{
+    return (uint64_t)chrono::duration_cast<chrono::nanoseconds>(Clock::now() - start_).count();
+}
+
+uint64_t Trace::payloadBytes(const Value& v){
+    switch (v.type){
+        case Value::Type::INT: return v.i.backend().size() * sizeof(boost::multiprecision::limb_type);
+        case Value::Type::STR: return v.s.size();
+        default: return sizeof(Value);
+    }
+}
+
+void Trace::record(const Event& e){
+    uint64_t slot = next_.fetch_add(1, memory_order_relaxed) & (CAPACITY - 1);
+    ring_[slot] = e;
+}
+
+void Trace::enter(uint32_t callee, bool builtin, size_t argc, uint64_t arg_bytes){
+    record({now(), arg_bytes, callee, (uint32_t)argc, true, builtin});
+}
+
+void Trace::leave(){
+    record({now(), 0, NO_NODE, 0, false, false});
+}
+
+static string jsonString(const string& s){
+    string out = "\"";
+    for (char c : s){
+        if (c=='"' || c=='\\') out += '\\';
+        out += c;
+    }
+    return out + '"';
+}
+
+void Trace::write(ostream& out) const{
+    uint64_t end = next_.load(memory_order_relaxed);
+    uint64_t begin = end > CAPACITY ? end - CAPACITY : 0;
+    char ts[32];
+    auto stamp = [&](uint64_t ns){
+        snprintf(ts, sizeof ts, "%llu.%03llu", (unsigned long long)(ns / 1000), (unsigned long long)(ns % 1000));
+        return ts;
+    };
+
+    out << "{\"traceEvents\":[\n";
+    bool first = true;
+    auto line = [&](){
+        if (!first) out << ",\n";
+        first = false;
+    };
+    size_t depth = 0;
+    uint64_t last = 0;
+    for (uint64_t i = begin; i < end; ++i){
+        const Event& e = ring_[i & (CAPACITY - 1)];
+        last = e.ns;
+        if (!e.begin){
+            if (!depth) continue; // its begin was overwritten
+            --depth;
+            line();
+            out << "{\"ph\":\"E\",\"ts\":" << stamp(e.ns) << ",\"pid\":1,\"tid\":1}";
+            continue;
+        }
+        ++depth;
+        line();
+        out << "{\"name\":" << jsonString(prog_.names[e.callee]) << ",\"cat\":\""
+            << (e.builtin ? "builtin" : "function") << "\",\"ph\":\"B\",\"ts\":" << stamp(e.ns)
+            << ",\"pid\":1,\"tid\":1,\"args\":{\"argc\":" << e.argc << ",\"arg_bytes\":" << e.arg_bytes << "}}";
+    }
+    for (; depth; --depth){
+        line();
+        out << "{\"ph\":\"E\",\"ts\":" << stamp(last) << ",\"pid\":1,\"tid\":1}";
+    }
+    out << "\n],\"displayTimeUnit\":\"ns\",\"otherData\":{\"dropped_events\":" << begin << "}}\n";
+}
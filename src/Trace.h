@@ -0,0 +1,52 @@
+#pragma once
+#ifndef PYTHON_INTERPRETER_TRACE_H
+#define PYTHON_INTERPRETER_TRACE_H
+
+#include "Ast.h"
+#include <atomic>
+#include <chrono>
+
+// Call timeline (--trace=PATH) in the Chrome trace-event format, readable by
+// chrome://tracing and Perfetto. Every user function and builtin call logs a
+// begin and an end event with its argument count and payload bytes.
+//
+// Events go into a fixed ring of CAPACITY slots claimed with one atomic
+// increment, so recording never locks or allocates; once full, the oldest
+// events are overwritten. write() flushes the ring at exit, drops end events
+// whose begin was overwritten and closes calls still open (a runtime error).
+class Trace {
+public:
+    using Clock = std::chrono::steady_clock;
+    static constexpr size_t CAPACITY = size_t(1) << 20; // power of two
+
+    explicit Trace(const Program& program);
+
+    // callee is the called name's symbol
+    void enter(uint32_t callee, bool builtin, size_t argc, uint64_t arg_bytes);
+    void leave();
+
+    void write(std::ostream& out) const;
+
+    // bytes of v's payload: int limbs, string characters, else the Value itself
+    static uint64_t payloadBytes(const Value& v);
+
+private:
+    struct Event {
+        uint64_t ns;       // since the trace started
+        uint64_t arg_bytes;
+        uint32_t callee;
+        uint32_t argc;
+        bool begin;
+        bool builtin;
+    };
+
+    const Program& prog_;
+    std::vector<Event> ring_;
+    Clock::time_point start_; // after the ring is allocated
+    std::atomic<uint64_t> next_{0}; // events ever recorded; slot = next_ % CAPACITY
+
+    void record(const Event& e);
+    uint64_t now() const;
+};
+
+#endif // PYTHON_INTERPRETER_TRACE_H
@@ -0,0 +1,624 @@
+#include "TypeInference.h"
+#include "Builtins.h"
+using namespace std;
+
+static constexpr int64_t NEG_INF = INT64_MIN;
+static constexpr int64_t POS_INF = INT64_MAX;
+using Wide = __int128;
+
+static StaticType typeOf(const Value& v){
+    switch (v.type){
+        case Value::Type::NONE: return StaticType::None;
+        case Value::Type::BOOL: return StaticType::Bool;
+        case Value::Type::INT: return StaticType::Int;
+        case Value::Type::FLOAT: return StaticType::Float;
+        case Value::Type::STR: return StaticType::Str;
+    }
+    return StaticType::Unknown;
+}
+
+// Interval arithmetic. Bounds past int64 saturate to the infinities, which
+// only ever loosens a range.
+static int64_t clamp(Wide v){ return v <= NEG_INF ? NEG_INF : v >= POS_INF ? POS_INF : (int64_t)v; }
+
+static Range rangeAdd(const Range& a, const Range& b){
+    Range r;
+    if (a.lo!=NEG_INF && b.lo!=NEG_INF) r.lo = clamp((Wide)a.lo + b.lo);
+    if (a.hi!=POS_INF && b.hi!=POS_INF) r.hi = clamp((Wide)a.hi + b.hi);
+    return r;
+}
+
+static Range rangeNeg(const Range& a){
+    Range r;
+    if (a.hi!=POS_INF) r.lo = clamp(-(Wide)a.hi);
+    if (a.lo!=NEG_INF) r.hi = clamp(-(Wide)a.lo);
+    return r;
+}
+
+static Range rangeMul(const Range& a, const Range& b){
+    if (!a.bounded() || !b.bounded()) return Range();
+    Wide c[4] = {(Wide)a.lo * b.lo, (Wide)a.lo * b.hi, (Wide)a.hi * b.lo, (Wide)a.hi * b.hi};
+    Range r;
+    r.lo = clamp(*min_element(c, c + 4));
+    r.hi = clamp(*max_element(c, c + 4));
+    return r;
+}
+
+static Wide floorDiv(Wide a, Wide b){
+    Wide q = a / b;
+    if (a % b != 0 && ((a < 0) != (b < 0))) --q;
+    return q;
+}
+
+static Range rangeFloorDiv(const Range& a, const Range& b){
+    if (!a.bounded()) return Range();
+    Range r;
+    if (b.bounded() && (b.lo > 0 || b.hi < 0)){
+        // monotone in each operand while the divisor keeps its sign
+        Wide c[4] = {floorDiv(a.lo, b.lo), floorDiv(a.lo, b.hi), floorDiv(a.hi, b.lo), floorDiv(a.hi, b.hi)};
+        r.lo = clamp(*min_element(c, c + 4));
+        r.hi = clamp(*max_element(c, c + 4));
+        return r;
+    }
+    // any int divisor is 0 (which raises) or at least 1 in magnitude
+    int64_t m = max(-a.lo, a.hi);
+    r.lo = -m;
+    r.hi = m;
+    return r;
+}
+
+static Range rangeMod(const Range& a, const Range& b){
+    // the result takes the divisor's sign and is smaller in magnitude
+    Range r;
+    if (b.lo > 0){
+        r.lo = 0;
+        if (b.hi != POS_INF) r.hi = b.hi - 1;
+        if (a.lo >= 0 && a.hi < r.hi) r.hi = a.hi;
+    }else if (b.hi < 0){
+        r.hi = 0;
+        if (b.lo != NEG_INF) r.lo = b.lo + 1;
+    }else if (b.bounded()){
+        int64_t m = max(-b.lo, b.hi);
+        r.lo = -(m - 1);
+        r.hi = m - 1;
+    }
+    return r;
+}
+
+vector<Fact> TypeInference::run(){
+    facts_.assign(prog_.nodes.size(), Fact());
+    module_assigned_.assign(prog_.names.size(), 0);
+    params_.assign(prog_.names.size(), 0);
+    collectModuleTargets(prog_.root);
+
+    in_function_ = false;
+    state_ = State();
+    stmt(prog_.root);
+    for (const Node& n : prog_.nodes){
+        if (n.kind==NodeKind::FuncDef) analyseFunction(n);
+    }
+    return std::move(facts_);
+}
+
+void TypeInference::collectModuleTargets(NodeId id){
+    const Node& n = prog_[id];
+    switch (n.kind){
+        case NodeKind::Block:
+            for (uint32_t i = 0; i < n.count; ++i) collectModuleTargets(prog_.child(n, i));
+            return;
+        case NodeKind::Assign:
+            for (uint32_t i = 0; i + 1 < n.count; ++i){
+                const Node& t = prog_[prog_.child(n, i)];
+                if (t.kind==NodeKind::Name) module_assigned_[t.a] = 1;
+                for (uint32_t j = 0; t.kind==NodeKind::Tuple && j < t.count; ++j){
+                    const Node& e = prog_[prog_.child(t, j)];
+                    if (e.kind==NodeKind::Name) module_assigned_[e.a] = 1;
+                }
+            }
+            return;
+        case NodeKind::AugAssign:
+            if (prog_[n.a].kind==NodeKind::Name) module_assigned_[prog_[n.a].a] = 1;
+            return;
+        case NodeKind::If:
+            for (uint32_t i = 1; i < n.count; i += 2) collectModuleTargets(prog_.child(n, i));
+            if (n.b!=NO_NODE) collectModuleTargets(n.b);
+            return;
+        case NodeKind::While:
+            collectModuleTargets(n.b);
+            return;
+        default:
+            return;
+    }
+}
+
+void TypeInference::analyseFunction(const Node& def){
+    fill(params_.begin(), params_.end(), 0);
+    for (uint32_t i = 0; i < def.count; ++i) params_[prog_[prog_.child(def, i)].a] = 1;
+    in_function_ = true;
+    state_ = State();
+    loops_.clear();
+    stmt(def.b);
+}
+
+Fact TypeInference::join(const Fact& a, const Fact& b){
+    if (a.type!=b.type) return Fact();
+    Fact r = a;
+    r.range.lo = min(a.range.lo, b.range.lo);
+    r.range.hi = max(a.range.hi, b.range.hi);
+    return r;
+}
+
+TypeInference::State TypeInference::join(const State& a, const State& b){
+    if (!a.reachable) return b;
+    if (!b.reachable) return a;
+    State r;
+    for (const auto& [sym, f] : a.vars){
+        auto it = b.vars.find(sym);
+        if (it==b.vars.end()) continue;
+        Fact j = join(f, it->second);
+        if (j.type!=StaticType::Unknown) r.vars.emplace(sym, j);
+    }
+    return r;
+}
+
+// next already contains head; bounds still moving go straight to infinity
+TypeInference::State TypeInference::widen(const State& head, const State& next){
+    State r = next;
+    for (auto& [sym, f] : r.vars){
+        const Range& old = head.vars.at(sym).range;
+        if (f.range.lo < old.lo) f.range.lo = NEG_INF;
+        if (f.range.hi > old.hi) f.range.hi = POS_INF;
+    }
+    return r;
+}
+
+// every fact in head also holds in next
+bool TypeInference::covers(const State& head, const State& next){
+    if (!next.reachable) return true;
+    if (!head.reachable) return false;
+    for (const auto& [sym, f] : head.vars){
+        auto it = next.vars.find(sym);
+        if (it==next.vars.end() || it->second.type!=f.type) return false;
+        if (it->second.range.lo < f.range.lo || it->second.range.hi > f.range.hi) return false;
+    }
+    return true;
+}
+
+bool TypeInference::sameState(const State& a, const State& b){
+    return a.reachable==b.reachable && a.vars==b.vars;
+}
+
+void TypeInference::killAfterCall(){
+    if (!in_function_){
+        state_.vars.clear();
+        return;
+    }
+    for (auto it = state_.vars.begin(); it != state_.vars.end();){
+        if (!params_[it->first] && module_assigned_[it->first]) it = state_.vars.erase(it);
+        else ++it;
+    }
+}
+
+void TypeInference::assignName(uint32_t sym, const Fact& f){
+    if (f.type==StaticType::Unknown) state_.vars.erase(sym);
+    else state_.vars[sym] = f;
+}
+
+// Statements
+void TypeInference::stmt(NodeId id){
+    const Node& n = prog_[id];
+    switch (n.kind){
+        case NodeKind::Block:
+            for (uint32_t i = 0; i < n.count && state_.reachable; ++i) stmt(prog_.child(n, i));
+            return;
+        case NodeKind::ExprStmt:
+            expr(n.a);
+            return;
+        case NodeKind::Assign: {
+            const Node& value = prog_[prog_.child(n, n.count - 1)];
+            vector<Fact> values;
+            if (value.kind==NodeKind::Tuple){
+                for (uint32_t i = 0; i < value.count; ++i) values.push_back(expr(prog_.child(value, i)));
+            }else{
+                values.push_back(expr(prog_.child(n, n.count - 1)));
+            }
+            for (uint32_t i = 0; i + 1 < n.count; ++i){
+                const Node& t = prog_[prog_.child(n, i)];
+                if (t.kind==NodeKind::Name) assignName(t.a, values.back());
+                else if (t.kind==NodeKind::Tuple && t.count==values.size()){
+                    for (uint32_t j = 0; j < t.count; ++j){
+                        const Node& e = prog_[prog_.child(t, j)];
+                        if (e.kind==NodeKind::Name) assignName(e.a, values[j]);
+                    }
+                }
+            }
+            return;
+        }
+        case NodeKind::AugAssign: {
+            Fact value = expr(n.b);
+            const Node& target = prog_[n.a];
+            if (target.kind!=NodeKind::Name) return;
+            auto it = state_.vars.find(target.a);
+            Fact current = it==state_.vars.end() ? Fact() : it->second;
+            facts_[n.a] = current;
+            facts_[id] = binary((BinOp)n.op, n.first, current, value);
+            assignName(target.a, facts_[id]);
+            return;
+        }
+        case NodeKind::If: {
+            State exits;
+            exits.reachable = false;
+            for (uint32_t i = 0; i + 1 < n.count; i += 2){
+                expr(prog_.child(n, i));
+                State untaken = state_;
+                refine(prog_.child(n, i), true);
+                stmt(prog_.child(n, i + 1));
+                exits = join(exits, state_);
+                state_ = std::move(untaken);
+                refine(prog_.child(n, i), false);
+            }
+            if (n.b!=NO_NODE) stmt(n.b);
+            state_ = join(exits, state_);
+            return;
+        }
+        case NodeKind::While:
+            loop(n);
+            return;
+        case NodeKind::Break:
+            if (!loops_.empty()) loops_.back().breaks = join(loops_.back().breaks, state_);
+            state_.reachable = false;
+            return;
+        case NodeKind::Continue:
+            if (!loops_.empty()) loops_.back().continues = join(loops_.back().continues, state_);
+            state_.reachable = false;
+            return;
+        case NodeKind::Return:
+            if (n.a!=NO_NODE) expr(n.a);
+            state_.reachable = false;
+            return;
+        case NodeKind::FuncDef:
+            // defaults are evaluated here; the body is analysed on its own
+            for (uint32_t i = 0; i < n.count; ++i){
+                const Node& p = prog_[prog_.child(n, i)];
+                if (p.b!=NO_NODE) expr(p.b);
+            }
+            return;
+        default:
+            return;
+    }
+}
+
+// The head state is joined with each back edge until nothing changes; after
+// WIDEN_AFTER passes growing ranges are widened, and the first head that
+// holds is narrowed by one more pass. The last pass leaves its facts behind.
+void TypeInference::loop(const Node& n){
+    State entry = state_;
+    State head = entry;
+    bool narrowed = false;
+    unordered_map<uint32_t, bool> steps;
+    collectSteps(n.b, steps);
+    vector<uint32_t> counters;
+    for (const auto& [sym, counter] : steps){
+        auto it = entry.vars.find(sym);
+        if (!counter || it==entry.vars.end() || it->second.type!=StaticType::Int) continue;
+        const Range& r = it->second.range;
+        if (r.lo >= -COUNTER_LIMIT && r.hi <= COUNTER_LIMIT) counters.push_back(sym);
+    }
+    for (int pass = 1;; ++pass){
+        state_ = head;
+        Loop body;
+        body.continues.reachable = body.breaks.reachable = false;
+        loops_.push_back(std::move(body));
+        expr(n.a);
+        State done = state_;
+        refine(n.a, true);
+        stmt(n.b);
+        body = std::move(loops_.back());
+        loops_.pop_back();
+        State next = join(entry, join(state_, body.continues));
+        for (uint32_t sym : counters){
+            auto it = next.vars.find(sym);
+            if (it==next.vars.end() || it->second.type!=StaticType::Int) continue;
+            Range& r = it->second.range;
+            r.lo = max(r.lo, -COUNTER_LIMIT);
+            r.hi = min(r.hi, COUNTER_LIMIT);
+        }
+        if (covers(head, next)){
+            if (!narrowed && !sameState(head, next)){
+                head = std::move(next);
+                narrowed = true;
+                continue;
+            }
+            state_ = std::move(done);
+            refine(n.a, false);
+            state_ = join(state_, body.breaks);
+            return;
+        }
+        State grown = join(head, next);
+        head = pass >= WIDEN_AFTER ? widen(head, grown) : std::move(grown);
+    }
+}
+
+// Marks every name a loop body assigns; it stays a counter only while each
+// assignment is a += or -= of a small int constant.
+void TypeInference::collectSteps(NodeId id, unordered_map<uint32_t, bool>& counters) const{
+    const Node& n = prog_[id];
+    switch (n.kind){
+        case NodeKind::Block:
+            for (uint32_t i = 0; i < n.count; ++i) collectSteps(prog_.child(n, i), counters);
+            return;
+        case NodeKind::Assign:
+            for (uint32_t i = 0; i + 1 < n.count; ++i){
+                const Node& t = prog_[prog_.child(n, i)];
+                if (t.kind==NodeKind::Name) counters[t.a] = false;
+                for (uint32_t j = 0; t.kind==NodeKind::Tuple && j < t.count; ++j){
+                    const Node& e = prog_[prog_.child(t, j)];
+                    if (e.kind==NodeKind::Name) counters[e.a] = false;
+                }
+            }
+            return;
+        case NodeKind::AugAssign: {
+            const Node& t = prog_[n.a];
+            if (t.kind!=NodeKind::Name) return;
+            const Node& step = prog_[n.b];
+            bool counting = ((BinOp)n.op==BinOp::Add || (BinOp)n.op==BinOp::Sub)
+                && step.kind==NodeKind::Const && prog_.constants[step.a].type==Value::Type::INT
+                && abs(prog_.constants[step.a].i) <= COUNTER_MAX_STEP;
+            auto it = counters.emplace(t.a, counting).first;
+            it->second = it->second && counting;
+            return;
+        }
+        case NodeKind::If:
+            for (uint32_t i = 1; i < n.count; i += 2) collectSteps(prog_.child(n, i), counters);
+            if (n.b!=NO_NODE) collectSteps(n.b, counters);
+            return;
+        case NodeKind::While:
+            collectSteps(n.b, counters);
+            return;
+        default:
+            return;
+    }
+}
+
+// Narrows the variables a condition tests on the path where it is truth.
+// A contradiction leaves the state alone: the path is dead either way.
+void TypeInference::refine(NodeId cond, bool truth){
+    const Node& n = prog_[cond];
+    switch (n.kind){
+        case NodeKind::Const:
+            if (isTruthy(prog_.constants[n.a])!=truth) state_.reachable = false;
+            return;
+        case NodeKind::Not:
+            refine(n.a, !truth);
+            return;
+        case NodeKind::And:
+            for (uint32_t i = 0; truth && i < n.count; ++i) refine(prog_.child(n, i), true);
+            return;
+        case NodeKind::Or:
+            for (uint32_t i = 0; !truth && i < n.count; ++i) refine(prog_.child(n, i), false);
+            return;
+        case NodeKind::Name: {
+            auto it = state_.vars.find(n.a);
+            if (it==state_.vars.end() || it->second.type!=StaticType::Int) return;
+            Range& r = it->second.range;
+            if (!truth){
+                if (r.lo <= 0 && r.hi >= 0) r.lo = r.hi = 0;
+            }else if (r.lo==0 && r.hi!=0){
+                r.lo = 1;
+            }else if (r.hi==0 && r.lo!=0){
+                r.hi = -1;
+            }
+            return;
+        }
+        case NodeKind::Compare: {
+            if (n.count!=3) return;
+            CmpOp op = (CmpOp)prog_.child(n, 1);
+            if (!truth){
+                switch (op){
+                    case CmpOp::Lt: op = CmpOp::Ge; break;
+                    case CmpOp::Gt: op = CmpOp::Le; break;
+                    case CmpOp::Eq: op = CmpOp::Ne; break;
+                    case CmpOp::Ge: op = CmpOp::Lt; break;
+                    case CmpOp::Le: op = CmpOp::Gt; break;
+                    case CmpOp::Ne: op = CmpOp::Eq; break;
+                }
+            }
+            refineCompare(prog_.child(n, 0), op, prog_.child(n, 2));
+            return;
+        }
+        default:
+            return;
+    }
+}
+
+void TypeInference::refineCompare(NodeId lhs, CmpOp op, NodeId rhs){
+    auto narrow = [&](NodeId var, CmpOp op, const Fact& other){
+        const Node& v = prog_[var];
+        if (v.kind!=NodeKind::Name || other.type!=StaticType::Int) return;
+        auto it = state_.vars.find(v.a);
+        if (it==state_.vars.end() || it->second.type!=StaticType::Int) return;
+        Range r = it->second.range;
+        const Range& o = other.range;
+        switch (op){
+            case CmpOp::Lt: if (o.hi!=POS_INF && o.hi!=NEG_INF) r.hi = min(r.hi, o.hi - 1); break;
+            case CmpOp::Le: if (o.hi!=POS_INF) r.hi = min(r.hi, o.hi); break;
+            case CmpOp::Gt: if (o.lo!=NEG_INF && o.lo!=POS_INF) r.lo = max(r.lo, o.lo + 1); break;
+            case CmpOp::Ge: if (o.lo!=NEG_INF) r.lo = max(r.lo, o.lo); break;
+            case CmpOp::Eq:
+                r.lo = max(r.lo, o.lo);
+                r.hi = min(r.hi, o.hi);
+                break;
+            case CmpOp::Ne:
+                if (!o.bounded() || o.lo!=o.hi) break;
+                if (r.lo==o.lo) ++r.lo;
+                else if (r.hi==o.hi) --r.hi;
+                break;
+        }
+        if (r.lo <= r.hi) it->second.range = r;
+    };
+    CmpOp mirrored = op;
+    switch (op){
+        case CmpOp::Lt: mirrored = CmpOp::Gt; break;
+        case CmpOp::Gt: mirrored = CmpOp::Lt; break;
+        case CmpOp::Ge: mirrored = CmpOp::Le; break;
+        case CmpOp::Le: mirrored = CmpOp::Ge; break;
+        default: break;
+    }
+    Fact left = facts_[lhs], right = facts_[rhs];
+    narrow(lhs, op, right);
+    narrow(rhs, mirrored, left);
+}
+
+// Result types follow the promotion rules in Value.cpp exactly.
+Fact TypeInference::binary(BinOp op, uint32_t k, const Fact& fa, const Fact& fb) const{
+    using T = StaticType;
+    T a = fa.type, b = fb.type;
+    Fact r;
+    // true division always yields a float and floor division always an int
+    if (op==BinOp::Div){
+        r.type = T::Float;
+        return r;
+    }
+    if (op==BinOp::FloorDiv || op==BinOp::FloorDivPow2) r.type = T::Int;
+    else if (a==T::Unknown || b==T::Unknown) return r;
+    else if (op==BinOp::Add && a==T::Str && b==T::Str) r.type = T::Str;
+    else if (op==BinOp::Mul && a==T::Str && (b==T::Int || b==T::Bool)) r.type = T::Str;
+    else if (op==BinOp::Mul && b==T::Str && (a==T::Int || a==T::Bool)) r.type = T::Str;
+    else r.type = a==T::Float || b==T::Float ? T::Float : T::Int;
+
+    if (r.type!=T::Int) return r;
+    if (op==BinOp::ModPow2){
+        // k < 64, so the mask itself fits unless k is 63
+        r.range.lo = 0;
+        if (k < 63) r.range.hi = (int64_t)((1ull << k) - 1);
+        if (a==T::Int && fa.range.lo >= 0 && fa.range.hi < r.range.hi) r.range.hi = fa.range.hi;
+        return r;
+    }
+    if (a!=T::Int || b!=T::Int){
+        if (op==BinOp::FloorDivPow2 && a==T::Int){
+            if (fa.range.lo!=NEG_INF) r.range.lo = fa.range.lo >> k;
+            if (fa.range.hi!=POS_INF) r.range.hi = fa.range.hi >> k;
+        }
+        return r;
+    }
+    switch (op){
+        case BinOp::Add: r.range = rangeAdd(fa.range, fb.range); break;
+        case BinOp::Sub: r.range = rangeAdd(fa.range, rangeNeg(fb.range)); break;
+        case BinOp::Mul: r.range = rangeMul(fa.range, fb.range); break;
+        case BinOp::FloorDiv: r.range = rangeFloorDiv(fa.range, fb.range); break;
+        case BinOp::Mod: r.range = rangeMod(fa.range, fb.range); break;
+        case BinOp::FloorDivPow2:
+            if (fa.range.lo!=NEG_INF) r.range.lo = fa.range.lo >> k;
+            if (fa.range.hi!=POS_INF) r.range.hi = fa.range.hi >> k;
+            break;
+        default: break;
+    }
+    return r;
+}
+
+Fact TypeInference::expr(NodeId id){
+    const Node& n = prog_[id];
+    Fact f;
+    switch (n.kind){
+        case NodeKind::Const: {
+            const Value& v = prog_.constants[n.a];
+            f.type = typeOf(v);
+            if (v.type==Value::Type::INT && v.i > NEG_INF && v.i < POS_INF){
+                f.range.lo = f.range.hi = v.i.convert_to<int64_t>();
+            }
+            break;
+        }
+        case NodeKind::Name: {
+            auto it = state_.vars.find(n.a);
+            if (it!=state_.vars.end()) f = it->second;
+            break;
+        }
+        case NodeKind::FString:
+            for (uint32_t i = 0; i < n.count; ++i) expr(prog_.child(n, i));
+            f.type = StaticType::Str;
+            break;
+        case NodeKind::Tuple:
+            for (uint32_t i = 0; i < n.count; ++i) f = expr(prog_.child(n, i));
+            break;
+        case NodeKind::Unary: {
+            Fact v = expr(n.a);
+            if ((UnaryOp)n.op==UnaryOp::Pos){
+                if (v.type==StaticType::Int || v.type==StaticType::Bool || v.type==StaticType::Float) f = v;
+                else if (v.type!=StaticType::Unknown) f.type = StaticType::None;
+            }else{
+                if (v.type==StaticType::Float) f.type = StaticType::Float;
+                else if (v.type==StaticType::Int) f = Fact{StaticType::Int, rangeNeg(v.range)};
+                else if (v.type==StaticType::Bool) f.type = StaticType::Int;
+                else if (v.type!=StaticType::Unknown) f.type = StaticType::None;
+            }
+            break;
+        }
+        case NodeKind::Not:
+            expr(n.a);
+            f.type = StaticType::Bool;
+            break;
+        case NodeKind::Binary: {
+            Fact a = expr(n.a);
+            Fact b = expr(n.b);
+            f = binary((BinOp)n.op, n.first, a, b);
+            break;
+        }
+        case NodeKind::And: case NodeKind::Or:
+            // any operand may be the result; later ones may not run, but kills are monotone
+            for (uint32_t i = 0; i < n.count; ++i){
+                Fact v = expr(prog_.child(n, i));
+                f = i ? join(f, v) : v;
+            }
+            break;
+        case NodeKind::Compare:
+            for (uint32_t i = 0; i < n.count; i += 2) expr(prog_.child(n, i));
+            f.type = StaticType::Bool;
+            break;
+        case NodeKind::Call:
+            f = call(n);
+            break;
+        default:
+            break;
+    }
+    facts_[id] = f;
+    return f;
+}
+
+Fact TypeInference::call(const Node& n){
+    if (n.b!=NO_NODE) expr(n.b);
+    vector<StaticType> args;
+    for (uint32_t i = 0; i < n.count; ++i){
+        const Node& arg = prog_[prog_.child(n, i)];
+        if (arg.kind==NodeKind::Keyword){
+            args.push_back(expr(arg.b).type);
+        }else{
+            args.push_back(expr(prog_.child(n, i)).type);
+        }
+    }
+    Fact r;
+    // a call through anything but a NAME yields None without calling anything
+    if (n.a==NO_NODE){
+        r.type = StaticType::None;
+        return r;
+    }
+    Builtin b = builtinOf(prog_.names[n.a]);
+    if (b==Builtin::None){
+        killAfterCall();
+        return r;
+    }
+    if (b==Builtin::Print || args.size()!=1){
+        r.type = StaticType::None;
+        return r;
+    }
+    switch (b){
+        case Builtin::Float: r.type = StaticType::Float; break;
+        case Builtin::Str: r.type = StaticType::Str; break;
+        case Builtin::Bool: r.type = StaticType::Bool; break;
+        case Builtin::Int:
+            // int("1.5") parses as a float
+            if (args[0]!=StaticType::Unknown && args[0]!=StaticType::Str) r.type = StaticType::Int;
+            break;
+        default: break;
+    }
+    return r;
+}
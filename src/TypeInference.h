@@ -0,0 +1,92 @@
+#pragma once
+#ifndef PYTHON_INTERPRETER_TYPE_INFERENCE_H
+#define PYTHON_INTERPRETER_TYPE_INFERENCE_H
+
+#include "Ast.h"
+
+// Static type of an expression; Unknown when it may differ between runs.
+enum class StaticType : uint8_t { Unknown, None, Bool, Int, Float, Str };
+
+// Closed interval an Int lies in. INT64_MIN / INT64_MAX stand for -inf / +inf,
+// so a bounded range is one whose every value fits an int64 (negated, too).
+struct Range {
+    int64_t lo = INT64_MIN;
+    int64_t hi = INT64_MAX;
+
+    bool bounded() const { return lo != INT64_MIN && hi != INT64_MAX; }
+    bool operator==(const Range& o) const { return lo==o.lo && hi==o.hi; }
+};
+
+// What is known about one expression; range is meaningful for Int only.
+struct Fact {
+    StaticType type = StaticType::Unknown;
+    Range range;
+
+    bool operator==(const Fact& o) const { return type==o.type && range==o.range; }
+};
+
+// Flow-sensitive type and range inference over one Program. Every expression
+// node (and every AugAssign target and result) gets the fact its value is
+// proven to satisfy whenever it is evaluated. Int ranges are narrowed by
+// branch and loop conditions; loops are iterated to a fixed point, widening
+// ranges that keep growing and then narrowing once.
+//
+// One range is assumed rather than proven: a loop counter that starts
+// bounded and only moves by a small constant step (x += 1) is taken to stay
+// within +-COUNTER_LIMIT, since leaving it would take some 2**46 iterations.
+// Consumers of ranges must therefore still guard their int64 fast paths.
+//
+// Variable facts survive only as long as nothing else can rebind the name:
+// a user call may rebind any global, and with it every function local whose
+// name is also assigned at module level (such locals can read and write
+// through to the global). Parameters live in the frame and are never killed.
+class TypeInference {
+public:
+    static constexpr int WIDEN_AFTER = 2; // loop passes joined exactly before widening
+    static constexpr int64_t COUNTER_LIMIT = int64_t(1) << 62;
+    static constexpr int64_t COUNTER_MAX_STEP = 1 << 16;
+
+    explicit TypeInference(const Program& program) : prog_(program) {}
+
+    // result[id] for every node id; other statements are left Unknown
+    std::vector<Fact> run();
+
+private:
+    struct State {
+        bool reachable = true;
+        std::unordered_map<uint32_t, Fact> vars; // symbol -> fact; missing = Unknown
+    };
+    struct Loop {
+        State continues; // joined states reaching the loop head again
+        State breaks;    // joined states leaving through break
+    };
+
+    const Program& prog_;
+    std::vector<Fact> facts_;
+    std::vector<char> module_assigned_; // symbol is a module-level assignment target
+    std::vector<char> params_;          // symbol is a parameter of the def being analysed
+    bool in_function_ = false;
+    State state_;
+    std::vector<Loop> loops_;
+
+    static Fact join(const Fact& a, const Fact& b);
+    static State join(const State& a, const State& b);
+    static State widen(const State& head, const State& next);
+    static bool covers(const State& head, const State& next);
+    static bool sameState(const State& a, const State& b);
+
+    void collectModuleTargets(NodeId id);
+    void analyseFunction(const Node& def);
+    void stmt(NodeId id);
+    void loop(const Node& n);
+    void collectSteps(NodeId id, std::unordered_map<uint32_t, bool>& counters) const;
+    void assignName(uint32_t sym, const Fact& f);
+    Fact expr(NodeId id);
+    Fact call(const Node& n);
+    Fact binary(BinOp op, uint32_t k, const Fact& a, const Fact& b) const;
+    void refine(NodeId cond, bool truth);
+    void refineCompare(NodeId lhs, CmpOp op, NodeId rhs);
+    void killAfterCall();
+};
+
+#endif // PYTHON_INTERPRETER_TYPE_INFERENCE_H
@@ -0,0 +1,728 @@
+#include "VM.h"
+#include "Interpreter.h"
+using boost::multiprecision::cpp_int;
+using namespace std;
+
+// Direct-threaded dispatch (labels as values): every handler ends in its own
+// indirect jump to the next one instead of returning to a shared switch.
+// Build with -DVM_NO_THREADING to get the portable switch loop.
+#if defined(__GNUC__) && !defined(VM_NO_THREADING)
+#define VM_THREADED 1
+#else
+#define VM_THREADED 0
+#endif
+
+// Int kernels shared by the specialized opcodes.
+static void intBinary(BinOp op, uint32_t k, const cpp_int& lhs, const cpp_int& rhs, cpp_int& out){
+    switch (op){
+        case BinOp::Add: out = lhs + rhs; break;
+        case BinOp::Sub: out = lhs - rhs; break;
+        case BinOp::Mul: out = lhs * rhs; break;
+        case BinOp::FloorDiv: out = floor_div_int(lhs, rhs); break;
+        case BinOp::Mod: out = mod_int(lhs, rhs); break;
+        case BinOp::FloorDivPow2: out = lhs >> k; break;
+        case BinOp::ModPow2: out = lhs & cpp_int((1ull << k) - 1); break;
+        case BinOp::Div: break; // never specialized
+    }
+}
+
+template <class T>
+static bool intCompare(CmpOp op, const T& lhs, const T& rhs){
+    switch (op){
+        case CmpOp::Lt: return lhs < rhs;
+        case CmpOp::Gt: return lhs > rhs;
+        case CmpOp::Eq: return lhs == rhs;
+        case CmpOp::Ge: return lhs >= rhs;
+        case CmpOp::Le: return lhs <= rhs;
+        case CmpOp::Ne: return lhs != rhs;
+    }
+    return false;
+}
+
+// Reads an int that fits an int64 straight out of cpp_int's inline limb;
+// false sends the caller to the bignum path.
+static inline bool smallInt(const cpp_int& v, int64_t& out){
+    const auto& backend = v.backend();
+    if (backend.size()!=1) return false;
+    uint64_t limb = backend.limbs()[0];
+    if (limb > (uint64_t)INT64_MAX) return false;
+    out = backend.sign() ? -(int64_t)limb : (int64_t)limb;
+    return true;
+}
+
+// int64 arithmetic with Python's floor semantics; false on overflow or a
+// zero divisor, which the bignum path handles (or raises for).
+static inline bool smallBinary(BinOp op, uint32_t k, int64_t lhs, int64_t rhs, int64_t& out){
+    switch (op){
+        case BinOp::Add: return !__builtin_add_overflow(lhs, rhs, &out);
+        case BinOp::Sub: return !__builtin_sub_overflow(lhs, rhs, &out);
+        case BinOp::Mul: return !__builtin_mul_overflow(lhs, rhs, &out);
+        case BinOp::FloorDiv: return floor_div_small(lhs, rhs, out);
+        case BinOp::Mod: return mod_small(lhs, rhs, out);
+        case BinOp::FloorDivPow2: out = lhs >> k; return true;
+        case BinOp::ModPow2: out = (int64_t)((uint64_t)lhs & ((1ull << k) - 1)); return true;
+        case BinOp::Div: return false;
+    }
+    return false;
+}
+
+static inline void intResult(BinOp op, uint32_t k, Spec spec, const cpp_int& lhs, const cpp_int& rhs, cpp_int& out){
+    int64_t x, y, r;
+    if (spec==Spec::Small && smallInt(lhs, x) && smallInt(rhs, y) && smallBinary(op, k, x, y, r)) out = r;
+    else intBinary(op, k, lhs, rhs, out);
+}
+
+static inline bool compareResult(CmpOp op, Spec spec, const Value& lhs, const Value& rhs){
+    if (spec==Spec::Generic) return Interpreter::compare(op, lhs, rhs);
+    int64_t x, y;
+    if (spec==Spec::Small && smallInt(lhs.i, x) && smallInt(rhs.i, y)) return intCompare(op, x, y);
+    return intCompare(op, lhs.i, rhs.i);
+}
+
+VM::VM(const Program& program, const Module& module, size_t stack_budget, bool jit, const Instrumentation& tools)
+    : prog_(program), mod_(module), budget_(stack_budget),
+      // profiles and counters need every line interpreted, so they turn the JIT off
+      jit_(jit && !tools.profiler && !tools.stats && LoopJit::available()),
+      // an inlined call has no frame to count, trace or charge a step for
+      inline_(!tools.stats && !tools.trace && !tools.budget),
+      per_instr_(tools.profiler || tools.stats || Memory::enabled()),
+      profiler_(tools.profiler), stats_(tools.stats), trace_(tools.trace), limits_(tools.budget),
+      globals_(program.names.size()),
+      global_bound_(program.names.size(), 0),
+      functions_(program.names.size()),
+      fn_version_(program.names.size(), 1),
+      builtins_(program.names.size(), Builtin::None),
+      call_cache_(module.calls.size()),
+      regs_(NativeLoop::REGS){
+    for (uint32_t sym = 0; sym < prog_.names.size(); ++sym) builtins_[sym] = builtinOf(prog_.names[sym]);
+    for (const CodeUnit& unit : mod_.units){
+        code_.push_back(unit.code);
+        lines_.push_back(unit.lines);
+    }
+}
+
+void VM::resolveCall(CallCache& ic, uint32_t sym){
+    // builtins shadow user definitions of the same name
+    ic.builtin = builtins_[sym];
+    ic.fn = ic.builtin==Builtin::None && functions_[sym].unit!=NO_NODE ? &functions_[sym] : nullptr;
+    ic.version = fn_version_[sym];
+}
+
+void VM::checkBudget() const{
+    size_t used = stack_.capacity() * sizeof(Value) + bound_.capacity() + frames_.capacity() * sizeof(Frame);
+    if (used > budget_){
+        throw runtime_error("RecursionError: maximum recursion depth exceeded (" + to_string(frames_.size())
+                            + " frames, stack budget " + to_string(budget_ >> 20) + " MiB)");
+    }
+}
+
+// Binds the arguments at stack_[first..] to fn's parameters and lays out its
+// slots from base; false (leaving the stack alone) if the arguments don't fit.
+bool VM::bindArguments(const Function& fn, const CallSite& site, size_t first, uint32_t base){
+    const CodeUnit& unit = mod_.units[fn.unit];
+    size_t n = unit.params.size();
+    vector<Value>& actual = bind_values_;
+    vector<char>& assigned = bind_assigned_;
+    actual.assign(n, Value::None());
+    assigned.assign(n, 0);
+    size_t posi = 0;
+    // positional first
+    for (size_t i = 0; i < site.names.size(); ++i){
+        if (site.names[i]==CallSite::POSITIONAL){
+            if (posi>=n) return false;
+            actual[posi] = std::move(stack_[first + i]); assigned[posi]=1; posi++;
+        }
+    }
+    // keywords
+    for (size_t i = 0; i < site.names.size(); ++i){
+        if (site.names[i]!=CallSite::POSITIONAL){
+            size_t idx = 0;
+            while (idx<n && unit.params[idx]!=site.names[i]) ++idx;
+            if (idx==n) return false;
+            actual[idx] = std::move(stack_[first + i]); assigned[idx]=1;
+        }
+    }
+    // fill defaults
+    for (size_t i=0;i<n;++i){
+        if (!assigned[i]){
+            if (i < unit.required_count) return false;
+            size_t j = i - unit.required_count; if (j<fn.defaults.size()) actual[i] = fn.defaults[j];
+        }
+    }
+    // fresh slots; a repeated parameter name binds the last value
+    size_t nslots = unit.slot_symbols.size();
+    stack_.resize(base);
+    stack_.resize(base + nslots);
+    bound_.resize(base + nslots);
+    fill(bound_.begin() + base, bound_.end(), 0);
+    for (size_t i=0;i<n;++i){
+        stack_[base + unit.param_slots[i]] = std::move(actual[i]);
+        bound_[base + unit.param_slots[i]] = 1;
+    }
+    return true;
+}
+
+// Copies the callee's `return <expr>` to the end of the caller's code, with
+// parameter reads turned into Peeks of the argument values already on the
+// stack, and turns the Call at `at` into an Inlined jump to the copy:
+//
+//     Inlined site, stub          stub: <expr, LoadLocal i -> Peek>
+//     ...                               InlineReturn nargs, at + 1
+//
+// Only plain positional calls to bodies made of a single return of a
+// call-free expression qualify, so the copy never recurses and needs no frame.
+bool VM::tryInline(uint32_t unit, uint32_t at, uint32_t site_index, CallCache& ic){
+    if (ic.inline_attempts >= INLINE_MAX_ATTEMPTS) return false;
+    const CallSite& site = mod_.calls[site_index];
+    const CodeUnit& callee = mod_.units[ic.fn->unit];
+    const vector<Instr>& body = code_[ic.fn->unit];
+    uint32_t n = (uint32_t)callee.params.size();
+    if (site.names.size()!=n || callee.slot_symbols.size()!=n) return false;
+    for (uint32_t name : site.names) if (name!=CallSite::POSITIONAL) return false;
+    for (uint32_t i = 0; i < n; ++i) if (callee.param_slots[i]!=i) return false; // repeated names
+
+    // the body must be <expr> Return; track the stack height to address the args
+    vector<Instr> stub;
+    uint32_t height = 0;
+    size_t end = 0;
+    while (end < body.size() && body[end].op!=Op::Return) ++end;
+    if (end==body.size() || end > INLINE_MAX_INSTRS) return false;
+    uint32_t start = (uint32_t)code_[unit].size();
+    for (size_t i = 0; i < end; ++i){
+        Instr in = body[i];
+        switch (in.op){
+            case Op::Const: case Op::LoadGlobal:
+                ++height; break;
+            case Op::LoadLocal:
+                // parameter in.a sits n - 1 - in.a below the arguments' top
+                in.op = Op::Peek;
+                in.a = n - 1 + height - in.a;
+                in.b = 0;
+                ++height; break;
+            case Op::BinaryOperands:
+                // parameters become stack references, as for LoadLocal
+                for (uint32_t* ref : {&in.b, &in.c}){
+                    if ((*ref & Operand::KIND)==Operand::LOCAL)
+                        *ref = Operand::PEEK | (n - 1 + height - (*ref & ~Operand::KIND));
+                }
+                ++height; break;
+            case Op::Unary: case Op::Not:
+                break;
+            case Op::Binary: case Op::BinaryInt: case Op::BinarySmall: case Op::BinaryFloat:
+            case Op::ConcatStr: case Op::Compare: case Op::CompareInt: case Op::CompareSmall:
+                --height; break;
+            case Op::CompareChain: case Op::JumpIfFalseOrPop: case Op::JumpIfTrueOrPop:
+                // both paths leave the same height at the target
+                if (in.a > end) return false;
+                in.a += start;
+                --height; break;
+            case Op::FString:
+                height = height - in.a + 1; break;
+            default:
+                return false; // calls, stores, loops, defs...
+        }
+        stub.push_back(in);
+    }
+    // its own op rather than a Jump, which would count as a loop back-edge
+    Instr ret; ret.op = Op::InlineReturn; ret.a = n; ret.b = at + 1;
+    stub.push_back(ret);
+
+    vector<Instr>& code = code_[unit];
+    code.insert(code.end(), stub.begin(), stub.end());
+    lines_[unit].resize(code.size(), lines_[unit][at]);
+    code[at].op = Op::Inlined;
+    code[at].b = start;
+    ic.inline_version = fn_version_[site.callee];
+    ++ic.inline_attempts;
+    return true;
+}
+
+// Compiles the loop code[top..end] of unit; on success its backward Jump at
+// end becomes a LoopNative. Jump.b counts the iterations until then.
+void VM::compileLoop(uint32_t unit, uint32_t top, uint32_t end){
+    unique_ptr<NativeLoop> loop = LoopJit::compile(prog_, code_[unit], top, end, limits_!=nullptr);
+    if (!loop) return;
+    Instr& at = code_[unit][end];
+    at.op = Op::LoopNative;
+    at.b = (uint32_t)native_loops_.size();
+    native_loops_.push_back(std::move(loop));
+}
+
+// Runs loop from its head if every variable it uses is a bound int that fits
+// an int64, then writes them back and resumes at the exit's pc. False (with
+// nothing changed) when a variable does not qualify. Under a budget the loop
+// gets the steps left before a check as fuel and is charged what it burnt.
+bool VM::enterNative(const NativeLoop& loop, uint32_t base, uint32_t& pc){
+    int64_t* regs = regs_.data();
+    for (size_t i = 0; i < loop.vars.size(); ++i){
+        const NativeLoop::Var& var = loop.vars[i];
+        bool bound = var.global ? global_bound_[var.index] : bound_[base + var.index];
+        const Value& v = var.global ? globals_[var.index] : stack_[base + var.index];
+        if (!bound || v.type!=Value::Type::INT || !smallInt(v.i, regs[i])) return false;
+    }
+    uint64_t fuel = limits_ ? min(limits_->allowance(), (uint64_t)INT64_MAX) : 0;
+    regs[NativeLoop::FUEL] = (int64_t)fuel;
+    const NativeLoop::Exit& exit = loop.exits[loop.run(regs)];
+    for (size_t i = 0; i < loop.vars.size(); ++i){
+        const NativeLoop::Var& var = loop.vars[i];
+        Value& v = var.global ? globals_[var.index] : stack_[base + var.index];
+        v.i = regs[i];
+    }
+    for (uint32_t j = 0; j < exit.depth; ++j) stack_.push_back(Value::fromInt((long long)regs[NativeLoop::MAX_VARS + j]));
+    pc = exit.pc;
+    if (limits_) limits_->spend(fuel - regs[NativeLoop::FUEL]); // fuel + 1 when it ran out
+    return true;
+}
+
+// Hands the profiler the call stack, with pc the next instruction of the
+// innermost frame; the others stopped at the Call before their saved pc.
+void VM::sample(uint32_t pc){
+    profile_stack_.clear();
+    for (size_t i = 0; i < frames_.size(); ++i){
+        const Frame& fr = frames_[i];
+        uint32_t at = i + 1==frames_.size() ? pc : fr.pc - 1;
+        profile_stack_.push_back({mod_.units[fr.unit].name, lines_[fr.unit][at]});
+    }
+    profiler_->sample(profile_stack_.data(), profile_stack_.size());
+}
+
+// Observer hooks, called from the OBSERVED run loop only.
+void VM::observeInstr(uint32_t pc){
+    if (profiler_ && Profiler::due()) sample(pc);
+    if (stats_) stats_->line(lines_[frames_.back().unit][pc]);
+    if (Memory::due()) checkMemory();
+}
+
+// a call of unit with its argc arguments at stack_[first..]
+void VM::observeEnter(uint32_t callee, bool builtin, uint32_t unit, size_t first, size_t argc){
+    if (stats_ && !builtin) stats_->enter(mod_.units[unit].name);
+    if (trace_){
+        uint64_t bytes = 0;
+        for (size_t i = first; i < first + argc; ++i) bytes += Trace::payloadBytes(stack_[i]);
+        trace_->enter(callee, builtin, argc, bytes);
+    }
+}
+
+void VM::observeLeave(bool builtin){
+    if (stats_ && !builtin) stats_->leave();
+    if (trace_) trace_->leave();
+}
+
+// Memory checkpoint over the globals, every frame's slots and temporaries,
+// and the code.
+void VM::checkMemory() const{
+    Memory::Usage usage;
+    size_t& env = usage.bytes[Memory::ENVIRONMENT];
+    env += globals_.capacity() * sizeof(Value) + global_bound_.capacity() + functions_.capacity() * sizeof(Function);
+    for (const Value& v : globals_) Memory::addValue(usage, v);
+    for (const Function& fn : functions_){
+        env += fn.defaults.capacity() * sizeof(Value);
+        for (const Value& v : fn.defaults) Memory::addValue(usage, v);
+    }
+    env += stack_.capacity() * sizeof(Value) + bound_.capacity() + frames_.capacity() * sizeof(Frame);
+    for (const Value& v : stack_) Memory::addValue(usage, v);
+    Memory::addProgram(usage, prog_);
+    for (size_t u = 0; u < code_.size(); ++u){
+        usage.bytes[Memory::PROGRAM] += (code_[u].capacity() + mod_.units[u].code.capacity()) * sizeof(Instr)
+                                      + (lines_[u].capacity() + mod_.units[u].lines.capacity()) * sizeof(uint32_t);
+    }
+    Memory::checkpoint(usage);
+}
+
+void VM::run(){
+    if (profiler_ || stats_ || trace_ || limits_ || Memory::enabled()) execute<true>();
+    else execute<false>();
+    if (Memory::enabled()) checkMemory();
+}
+
+// OBSERVED runs the profiler, stats, trace, memory and budget hooks; without
+// it the loop is exactly the plain one.
+template <bool OBSERVED>
+void VM::execute(){
+    frames_.push_back({nullptr, 0, 0, 0});
+    Instr* code = code_[0].data();
+    uint32_t pc = 0;
+    uint32_t base = 0;
+    const Value none;
+    // reads a superinstruction operand in place; extra counts values pushed since
+    auto operand = [&](uint32_t ref, size_t extra = 0) -> const Value& {
+        uint32_t index = ref & ~Operand::KIND;
+        switch (ref & Operand::KIND){
+            case Operand::CONST: return prog_.constants[index];
+            case Operand::LOCAL:
+                if (bound_[base + index]) return stack_[base + index];
+                index = mod_.units[frames_.back().unit].slot_symbols[index];
+                return global_bound_[index] ? globals_[index] : none;
+            case Operand::GLOBAL: return global_bound_[index] ? globals_[index] : none;
+            default: return stack_[stack_.size() - 1 - extra - index];
+        }
+    };
+
+#define OBSERVE() do { if (OBSERVED && per_instr_) observeInstr(pc); } while (0)
+#if VM_THREADED
+    // in Op order
+    static const void* const targets[] = {
+        &&op_Const, &&op_LoadGlobal, &&op_LoadLocal, &&op_StoreGlobal, &&op_StoreLocal,
+        &&op_Peek, &&op_Pop, &&op_Unary, &&op_Not, &&op_Binary, &&op_BinaryInt,
+        &&op_BinarySmall, &&op_BinaryFloat, &&op_ConcatStr, &&op_Compare, &&op_CompareInt,
+        &&op_CompareSmall, &&op_CompareChain, &&op_JumpIfFalseOrPop, &&op_JumpIfTrueOrPop,
+        &&op_Jump, &&op_JumpIfFalse, &&op_FString, &&op_Call, &&op_Return, &&op_MakeFunction,
+        &&op_Fail, &&op_Inlined, &&op_InlineReturn, &&op_BinaryOperands, &&op_AugLocal,
+        &&op_AugGlobal, &&op_CompareJump, &&op_LoopNative,
+    };
+    static_assert(sizeof(targets) / sizeof(targets[0])==(size_t)Op::LoopNative + 1, "one target per opcode");
+#define TARGET(name) case Op::name: op_##name:
+#define DISPATCH() do { OBSERVE(); in = code[pc++]; goto *targets[(size_t)in.op]; } while (0)
+#else
+#define TARGET(name) case Op::name:
+#define DISPATCH() continue
+#endif
+
+    Instr in;
+    for (;;){
+        OBSERVE();
+        in = code[pc++];
+#if VM_THREADED
+        goto *targets[(size_t)in.op];
+#endif
+        switch (in.op){
+            TARGET(Const)
+                stack_.push_back(prog_.constants[in.a]);
+                DISPATCH();
+            TARGET(LoadGlobal)
+                stack_.push_back(global_bound_[in.a] ? globals_[in.a] : none);
+                DISPATCH();
+            TARGET(LoadLocal)
+                if (bound_[base + in.a]) stack_.push_back(stack_[base + in.a]);
+                else stack_.push_back(global_bound_[in.b] ? globals_[in.b] : none);
+                DISPATCH();
+            TARGET(StoreGlobal)
+                globals_[in.a] = std::move(stack_.back());
+                global_bound_[in.a] = 1;
+                stack_.pop_back();
+                DISPATCH();
+            TARGET(StoreLocal)
+                // names not yet bound globally become locals of the running call
+                if (bound_[base + in.a] || !global_bound_[in.b]){
+                    stack_[base + in.a] = std::move(stack_.back());
+                    bound_[base + in.a] = 1;
+                }else{
+                    globals_[in.b] = std::move(stack_.back());
+                }
+                stack_.pop_back();
+                DISPATCH();
+            TARGET(Peek)
+                stack_.push_back(stack_[stack_.size() - 1 - in.a]);
+                DISPATCH();
+            TARGET(Pop)
+                stack_.pop_back();
+                DISPATCH();
+            TARGET(Unary)
+                stack_.back() = Interpreter::unary((UnaryOp)in.aux, stack_.back());
+                DISPATCH();
+            TARGET(Not)
+                stack_.back() = Value::fromBool(!isTruthy(stack_.back()));
+                DISPATCH();
+            TARGET(Binary) {
+                size_t top = stack_.size();
+                const Value& lhs = stack_[in.b ? top - 1 : top - 2];
+                const Value& rhs = stack_[in.b ? top - 2 : top - 1];
+                if (OBSERVED && stats_) stats_->binary((BinOp)in.aux, lhs, rhs);
+                Value r = Interpreter::binary((BinOp)in.aux, lhs, rhs, in.a);
+                stack_.pop_back();
+                stack_.back() = std::move(r);
+                DISPATCH();
+            }
+            TARGET(BinaryInt) {
+                size_t top = stack_.size();
+                Value& dst = stack_[top - 2];
+                if (OBSERVED && stats_) stats_->binary((BinOp)in.aux, stack_[in.b ? top - 1 : top - 2], stack_[in.b ? top - 2 : top - 1]);
+                const cpp_int& lhs = stack_[in.b ? top - 1 : top - 2].i;
+                const cpp_int& rhs = stack_[in.b ? top - 2 : top - 1].i;
+                intBinary((BinOp)in.aux, in.a, lhs, rhs, dst.i);
+                stack_.pop_back();
+                DISPATCH();
+            }
+            TARGET(BinarySmall) {
+                size_t top = stack_.size();
+                Value& dst = stack_[top - 2];
+                if (OBSERVED && stats_) stats_->binary((BinOp)in.aux, stack_[in.b ? top - 1 : top - 2], stack_[in.b ? top - 2 : top - 1]);
+                const cpp_int& lhs = stack_[in.b ? top - 1 : top - 2].i;
+                const cpp_int& rhs = stack_[in.b ? top - 2 : top - 1].i;
+                int64_t x, y, r;
+                // the range proof says this always holds; the guard keeps it honest
+                if (smallInt(lhs, x) && smallInt(rhs, y) && smallBinary((BinOp)in.aux, in.a, x, y, r)) dst.i = r;
+                else intBinary((BinOp)in.aux, in.a, lhs, rhs, dst.i);
+                stack_.pop_back();
+                DISPATCH();
+            }
+            TARGET(BinaryFloat) {
+                size_t top = stack_.size();
+                Value& dst = stack_[top - 2];
+                double lhs = stack_[in.b ? top - 1 : top - 2].f;
+                double rhs = stack_[in.b ? top - 2 : top - 1].f;
+                switch ((BinOp)in.aux){
+                    case BinOp::Add: dst.f = lhs + rhs; break;
+                    case BinOp::Sub: dst.f = lhs - rhs; break;
+                    case BinOp::Mul: dst.f = lhs * rhs; break;
+                    default: dst.f = lhs / rhs; break;
+                }
+                stack_.pop_back();
+                DISPATCH();
+            }
+            TARGET(ConcatStr) {
+                size_t top = stack_.size();
+                if (in.b) stack_[top - 2].s.insert(0, stack_[top - 1].s);
+                else stack_[top - 2].s += stack_[top - 1].s;
+                stack_.pop_back();
+                DISPATCH();
+            }
+            TARGET(CompareInt) {
+                bool r = intCompare((CmpOp)in.aux, stack_[stack_.size() - 2].i, stack_.back().i);
+                stack_.pop_back();
+                stack_.back() = Value::fromBool(r);
+                DISPATCH();
+            }
+            TARGET(CompareSmall) {
+                const cpp_int& lhs = stack_[stack_.size() - 2].i;
+                const cpp_int& rhs = stack_.back().i;
+                int64_t x, y;
+                bool r = smallInt(lhs, x) && smallInt(rhs, y) ? intCompare((CmpOp)in.aux, x, y)
+                                                             : intCompare((CmpOp)in.aux, lhs, rhs);
+                stack_.pop_back();
+                stack_.back() = Value::fromBool(r);
+                DISPATCH();
+            }
+            TARGET(Compare) {
+                bool r = Interpreter::compare((CmpOp)in.aux, stack_[stack_.size() - 2], stack_.back());
+                stack_.pop_back();
+                stack_.back() = Value::fromBool(r);
+                DISPATCH();
+            }
+            TARGET(CompareChain) {
+                bool r = Interpreter::compare((CmpOp)in.aux, stack_[stack_.size() - 2], stack_.back());
+                if (r){
+                    stack_[stack_.size() - 2] = std::move(stack_.back());
+                    stack_.pop_back();
+                }else{
+                    stack_.pop_back();
+                    stack_.back() = Value::fromBool(false);
+                    pc = in.a;
+                }
+                DISPATCH();
+            }
+            TARGET(JumpIfFalseOrPop)
+                if (!isTruthy(stack_.back())) pc = in.a;
+                else stack_.pop_back();
+                DISPATCH();
+            TARGET(JumpIfTrueOrPop)
+                if (isTruthy(stack_.back())) pc = in.a;
+                else stack_.pop_back();
+                DISPATCH();
+            TARGET(Jump)
+                if (OBSERVED && limits_ && in.a < pc) limits_->step();
+                if (in.a < pc && jit_ && ++code[pc - 1].b==JIT_THRESHOLD) compileLoop(frames_.back().unit, in.a, pc - 1);
+                pc = in.a;
+                DISPATCH();
+            TARGET(JumpIfFalse) {
+                bool t = isTruthy(stack_.back());
+                stack_.pop_back();
+                if (!t) pc = in.a;
+                DISPATCH();
+            }
+            TARGET(FString) {
+                size_t first = stack_.size() - in.a;
+                string out;
+                for (size_t i = first; i < stack_.size(); ++i) out += toString(stack_[i]);
+                stack_.resize(first);
+                stack_.push_back(Value::fromStr(std::move(out)));
+                DISPATCH();
+            }
+            TARGET(Call) {
+                const CallSite& site = mod_.calls[in.a];
+                size_t first = stack_.size() - site.names.size();
+                if (site.callee==NO_NODE){
+                    // a call through anything but a NAME is not supported and yields None
+                    stack_.resize(first);
+                    stack_.push_back(none);
+                    DISPATCH();
+                }
+                CallCache& ic = call_cache_[in.a];
+                if (ic.version!=fn_version_[site.callee]) resolveCall(ic, site.callee);
+                if (ic.builtin!=Builtin::None){
+                    if (OBSERVED) observeEnter(site.callee, true, 0, first, site.names.size());
+                    Value r = callBuiltin(ic.builtin, stack_.data() + first, site.names.size());
+                    if (OBSERVED) observeLeave(true);
+                    stack_.resize(first);
+                    stack_.push_back(std::move(r));
+                    DISPATCH();
+                }
+                if (!ic.fn){
+                    // unknown callable -> None
+                    stack_.resize(first);
+                    stack_.push_back(none);
+                    DISPATCH();
+                }
+                if ((!OBSERVED || inline_) && ++ic.hits==INLINE_THRESHOLD && tryInline(frames_.back().unit, pc - 1, in.a, ic)){
+                    // run the rewritten instruction instead
+                    code = code_[frames_.back().unit].data();
+                    --pc;
+                    DISPATCH();
+                }
+                if (OBSERVED && limits_) limits_->step();
+                Frame& caller = frames_.back();
+                if (in.aux && ic.fn==caller.fn){
+                    // return f(...) in tail position: rebind this frame and restart it
+                    if (OBSERVED){
+                        observeLeave(false);
+                        observeEnter(site.callee, false, ic.fn->unit, first, site.names.size());
+                    }
+                    if (!bindArguments(*ic.fn, site, first, base)){
+                        stack_.resize(first);
+                        stack_.push_back(none);
+                        DISPATCH();
+                    }
+                    caller.unit = ic.fn->unit;
+                    code = code_[caller.unit].data();
+                    pc = 0;
+                    DISPATCH();
+                }
+                if (OBSERVED) observeEnter(site.callee, false, ic.fn->unit, first, site.names.size());
+                if (!bindArguments(*ic.fn, site, first, (uint32_t)first)){
+                    if (OBSERVED) observeLeave(false);
+                    stack_.resize(first);
+                    stack_.push_back(none);
+                    DISPATCH();
+                }
+                caller.pc = pc;
+                frames_.push_back({ic.fn, ic.fn->unit, 0, (uint32_t)first});
+                checkBudget();
+                code = code_[ic.fn->unit].data();
+                pc = 0;
+                base = (uint32_t)first;
+                DISPATCH();
+            }
+            TARGET(Return) {
+                Value result = std::move(stack_.back());
+                stack_.resize(base);
+                if (OBSERVED && frames_.size() > 1) observeLeave(false);
+                frames_.pop_back();
+                if (frames_.empty()) return;
+                const Frame& fr = frames_.back();
+                stack_.push_back(std::move(result));
+                code = code_[fr.unit].data();
+                pc = fr.pc;
+                base = fr.base;
+                DISPATCH();
+            }
+            TARGET(MakeFunction) {
+                const CodeUnit& unit = mod_.units[in.a];
+                Function fn;
+                fn.unit = in.a;
+                size_t first = stack_.size() - in.b;
+                for (size_t i = first; i < stack_.size(); ++i) fn.defaults.push_back(std::move(stack_[i]));
+                stack_.resize(first);
+                functions_[unit.name] = std::move(fn);
+                ++fn_version_[unit.name]; // drops every call site cached against the old def
+                DISPATCH();
+            }
+            TARGET(Fail)
+                throw runtime_error(prog_.constants[in.a].s);
+            TARGET(Inlined) {
+                const CallSite& site = mod_.calls[in.a];
+                CallCache& ic = call_cache_[in.a];
+                if (fn_version_[site.callee]==ic.inline_version){
+                    pc = in.b;
+                    DISPATCH();
+                }
+                // the callee was redefined: deoptimize back to an ordinary call
+                Instr& at = code_[frames_.back().unit][pc - 1];
+                at.op = Op::Call;
+                at.b = 0;
+                ic.hits = 0;
+                --pc;
+                DISPATCH();
+            }
+            TARGET(InlineReturn)
+                if (in.a){
+                    size_t first = stack_.size() - 1 - in.a;
+                    stack_[first] = std::move(stack_.back());
+                    stack_.resize(first + 1);
+                }
+                pc = in.b;
+                DISPATCH();
+            TARGET(BinaryOperands) {
+                // push first so the operand references stay valid
+                stack_.emplace_back();
+                Value& dst = stack_.back();
+                const Value& lhs = operand(in.b, 1);
+                const Value& rhs = operand(in.c, 1);
+                if (OBSERVED && stats_) stats_->binary((BinOp)in.aux, lhs, rhs);
+                if (in.spec==Spec::Generic){
+                    dst = Interpreter::binary((BinOp)in.aux, lhs, rhs, in.a);
+                }else{
+                    dst.type = Value::Type::INT;
+                    intResult((BinOp)in.aux, in.a, in.spec, lhs.i, rhs.i, dst.i);
+                }
+                DISPATCH();
+            }
+            TARGET(AugLocal) {
+                uint32_t slot = base + in.a;
+                const Value& rhs = operand(in.c);
+                if (bound_[slot]){
+                    Value& target = stack_[slot];
+                    if (OBSERVED && stats_) stats_->binary((BinOp)in.aux, target, rhs);
+                    if (in.spec==Spec::Generic) target = Interpreter::binary((BinOp)in.aux, target, rhs, in.b);
+                    else intResult((BinOp)in.aux, in.b, in.spec, target.i, rhs.i, target.i);
+                    DISPATCH();
+                }
+                // the slot is unbound: read the global, then store as StoreLocal would
+                uint32_t sym = mod_.units[frames_.back().unit].slot_symbols[in.a];
+                if (OBSERVED && stats_ && global_bound_[sym]) stats_->binary((BinOp)in.aux, globals_[sym], rhs);
+                Value r = Interpreter::binary((BinOp)in.aux, global_bound_[sym] ? globals_[sym] : none, rhs, in.b);
+                if (global_bound_[sym]){
+                    globals_[sym] = std::move(r);
+                }else{
+                    stack_[slot] = std::move(r);
+                    bound_[slot] = 1;
+                }
+                DISPATCH();
+            }
+            TARGET(AugGlobal) {
+                Value& target = globals_[in.a];
+                const Value& rhs = operand(in.c);
+                if (OBSERVED && stats_) stats_->binary((BinOp)in.aux, target, rhs);
+                if (in.spec!=Spec::Generic){
+                    intResult((BinOp)in.aux, in.b, in.spec, target.i, rhs.i, target.i);
+                }else{
+                    target = Interpreter::binary((BinOp)in.aux, global_bound_[in.a] ? target : none, rhs, in.b);
+                    global_bound_[in.a] = 1;
+                }
+                DISPATCH();
+            }
+            TARGET(CompareJump) {
+                bool r;
+                if (in.b==Operand::TOP){
+                    r = compareResult((CmpOp)in.aux, in.spec, stack_.back(), operand(in.c));
+                    stack_.pop_back();
+                }else{
+                    r = compareResult((CmpOp)in.aux, in.spec, operand(in.b), operand(in.c));
+                }
+                if (!r) pc = in.a;
+                DISPATCH();
+            }
+            TARGET(LoopNative) {
+                NativeLoop& loop = *native_loops_[in.b];
+                uint32_t at = pc - 1;
+                pc = in.a;
+                if (OBSERVED && limits_) limits_->step();
+                // a var that outgrew int64 (or changed type) keeps the loop interpreted
+                if (!enterNative(loop, base, pc) && ++loop.entry_failures==JIT_MAX_ENTRY_FAILURES) code[at].op = Op::Jump;
+                DISPATCH();
+            }
+        }
+    }
+#undef TARGET
+#undef DISPATCH
+#undef OBSERVE
+}
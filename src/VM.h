@@ -0,0 +1,102 @@
+#pragma once
+#ifndef PYTHON_INTERPRETER_VM_H
+#define PYTHON_INTERPRETER_VM_H
+
+#include "Builtins.h"
+#include "Bytecode.h"
+#include "Instrumentation.h"
+#include "Jit.h"
+#include "Memory.h"
+
+// Stackless bytecode engine. Interpreted calls push a Frame onto a heap
+// vector instead of recursing in C++, so recursion depth is bounded only by
+// the memory budget given to the constructor.
+//
+// Call sites that keep hitting the same small function get the callee's
+// return expression spliced into the caller's code (see tryInline); a later
+// def of that name sends the site back to an ordinary call.
+//
+// A while-loop whose backward jump keeps being taken is handed to LoopJit;
+// if it compiles, the jump becomes a LoopNative that runs the machine code
+// whenever the loop's variables are all small ints on entry. Under a step
+// budget the machine code is metered, so it counts the same steps.
+class VM {
+public:
+    static constexpr size_t DEFAULT_STACK_BUDGET = 256u << 20; // bytes
+    static constexpr uint32_t INLINE_THRESHOLD = 64;   // calls before a site is inlined
+    static constexpr size_t INLINE_MAX_INSTRS = 32;    // callee expression size limit
+    static constexpr uint8_t INLINE_MAX_ATTEMPTS = 4;  // per site, across redefinitions
+    static constexpr uint32_t JIT_THRESHOLD = 100;     // backward jumps before a loop is compiled
+    static constexpr uint32_t JIT_MAX_ENTRY_FAILURES = 16; // refused entries before a loop stays interpreted
+
+    VM(const Program& program, const Module& module, size_t stack_budget = DEFAULT_STACK_BUDGET, bool jit = true,
+       const Instrumentation& tools = {});
+
+    void run();
+
+private:
+    struct Function {
+        uint32_t unit = NO_NODE; // NO_NODE while the symbol has no def
+        std::vector<Value> defaults;
+    };
+    struct CallCache {
+        uint32_t version = 0; // 0 = never resolved
+        Builtin builtin = Builtin::None;
+        const Function* fn = nullptr;
+        uint32_t hits = 0;
+        uint32_t inline_version = 0; // def version the inlined copy was made from
+        uint8_t inline_attempts = 0;
+    };
+    struct Frame {
+        const Function* fn; // nullptr for the module
+        uint32_t unit;
+        uint32_t pc;
+        uint32_t base;      // first local slot in stack_
+    };
+
+    const Program& prog_;
+    const Module& mod_;
+    size_t budget_;
+    bool jit_;
+    bool inline_;
+    bool per_instr_; // some hook runs before every instruction
+    // observers and the step budget, all optional
+    Profiler* profiler_;
+    Stats* stats_;
+    Trace* trace_;
+    Budget* limits_;
+
+    // indexed by symbol id
+    std::vector<Value> globals_;
+    std::vector<char> global_bound_;
+    std::vector<Function> functions_;
+    std::vector<uint32_t> fn_version_;
+    std::vector<Builtin> builtins_;
+    std::vector<CallCache> call_cache_; // indexed by call site
+
+    std::vector<std::vector<Instr>> code_; // per unit; rewritten by inlining
+    std::vector<std::vector<uint32_t>> lines_; // per unit, parallel to code_
+    std::vector<Frame> frames_;
+    std::vector<Value> stack_;  // local slots of every frame, then temporaries
+    std::vector<char> bound_;   // parallel to the slot part of stack_
+    std::vector<Value> bind_values_;
+    std::vector<char> bind_assigned_;
+    std::vector<std::unique_ptr<NativeLoop>> native_loops_;
+    std::vector<int64_t> regs_; // register file of the running native loop
+    std::vector<Profiler::Frame> profile_stack_;
+
+    void resolveCall(CallCache& ic, uint32_t sym);
+    bool bindArguments(const Function& fn, const CallSite& site, size_t first, uint32_t base);
+    void checkBudget() const;
+    bool tryInline(uint32_t unit, uint32_t at, uint32_t site, CallCache& ic);
+    template <bool OBSERVED> void execute();
+    void observeInstr(uint32_t pc);
+    void observeEnter(uint32_t callee, bool builtin, uint32_t unit, size_t first, size_t argc);
+    void observeLeave(bool builtin);
+    void checkMemory() const;
+    void sample(uint32_t pc);
+    void compileLoop(uint32_t unit, uint32_t top, uint32_t end);
+    bool enterNative(const NativeLoop& loop, uint32_t base, uint32_t& pc);
+};
+
+#endif // PYTHON_INTERPRETER_VM_H
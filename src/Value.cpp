@@ -0,0 +1,170 @@
+#include "Value.h"
+using boost::multiprecision::cpp_int;
+using namespace std;
+
+// Convert Value to string per assignment requirements
+string toString(const Value& v){
+    switch(v.type){
+        case Value::Type::NONE: return "None";
+        case Value::Type::BOOL: return v.b?"True":"False";
+        case Value::Type::INT: {
+            return v.i.convert_to<string>();
+        }
+        case Value::Type::FLOAT: {
+            ostringstream oss; oss.setf(std::ios::fixed); oss<<setprecision(6)<<v.f; return oss.str();
+        }
+        case Value::Type::STR: return v.s;
+    }
+    return "";
+}
+
+// Truthiness similar to Python
+bool isTruthy(const Value& v){
+    switch(v.type){
+        case Value::Type::NONE: return false;
+        case Value::Type::BOOL: return v.b;
+        case Value::Type::INT: return v.i != 0;
+        case Value::Type::FLOAT: return v.f != 0.0;
+        case Value::Type::STR: return !v.s.empty();
+    }
+    return false;
+}
+
+// Parse numeric literal
+Value parseNumber(const string& text){
+    if (text.find('.') != string::npos){
+        return Value::fromFloat(strtod(text.c_str(), nullptr));
+    }else{
+        cpp_int x = 0; bool neg=false; size_t p=0; if(text.size()>0 && (text[0]=='+'||text[0]=='-')){neg=text[0]=='-'; p=1;}
+        for(;p<text.size();++p){ if(isdigit((unsigned char)text[p])){ x *= 10; x += (text[p]-'0'); } }
+        if(neg) x = -x; return Value::fromInt(x);
+    }
+}
+
+// Remove quotes around a normal STRING token
+string parseStringToken(const string& t){
+    if (t.size()>=2 && ( (t.front()=='"' && t.back()=='"') || (t.front()=='\'' && t.back()=='\'') )){
+        string inner = t.substr(1, t.size()-2);
+        // No escapes in spec; treat doubled quotes as literal (undefined)
+        return inner;
+    }
+    return t;
+}
+
+static string replace_all(string s, const string& from, const string& to){
+    if (from.empty()) return s;
+    size_t pos=0; while((pos=s.find(from,pos))!=string::npos){ s.replace(pos, from.size(), to); pos += to.size(); }
+    return s;
+}
+
+// FORMAT_STRING_LITERAL text: escaped braces become literal braces
+string parseFormatLiteral(const string& t){
+    return replace_all(replace_all(t, "{{", "{"), "}}", "}");
+}
+
+// Comparison helper: returns -1/0/1, throws if incomparable
+int cmp(const Value& a, const Value& b){
+    // numbers
+    if ((a.type==Value::Type::INT || a.type==Value::Type::FLOAT || a.type==Value::Type::BOOL) &&
+        (b.type==Value::Type::INT || b.type==Value::Type::FLOAT || b.type==Value::Type::BOOL)){
+        // promote to float if any is float
+        if (a.type==Value::Type::FLOAT || b.type==Value::Type::FLOAT){
+            double x = (a.type==Value::Type::FLOAT)? a.f : (a.type==Value::Type::INT? a.i.convert_to<double>() : (a.b?1.0:0.0));
+            double y = (b.type==Value::Type::FLOAT)? b.f : (b.type==Value::Type::INT? b.i.convert_to<double>() : (b.b?1.0:0.0));
+            if (x<y) return -1; if (x>y) return 1; return 0;
+        }else{ // both integral/bool
+            cpp_int x = (a.type==Value::Type::INT)? a.i : cpp_int(a.b?1:0);
+            cpp_int y = (b.type==Value::Type::INT)? b.i : cpp_int(b.b?1:0);
+            if (x<y) return -1; if (x>y) return 1; return 0;
+        }
+    }
+    if (a.type==Value::Type::STR && b.type==Value::Type::STR){
+        if (a.s<b.s) return -1; if (a.s>b.s) return 1; return 0;
+    }
+    if (a.type==Value::Type::NONE && b.type==Value::Type::NONE) return 0;
+    throw runtime_error("incomparable types");
+}
+
+// Arithmetic helpers
+Value add(const Value& a, const Value& b){
+    if (a.type==Value::Type::STR && b.type==Value::Type::STR) return Value::fromStr(a.s + b.s);
+    if (a.type==Value::Type::FLOAT || b.type==Value::Type::FLOAT){
+        double x = (a.type==Value::Type::FLOAT)? a.f : (a.type==Value::Type::INT? a.i.convert_to<double>() : (a.type==Value::Type::BOOL? (a.b?1.0:0.0):0.0));
+        double y = (b.type==Value::Type::FLOAT)? b.f : (b.type==Value::Type::INT? b.i.convert_to<double>() : (b.type==Value::Type::BOOL? (b.b?1.0:0.0):0.0));
+        return Value::fromFloat(x+y);
+    }
+    // treat bool as int
+    cpp_int x = (a.type==Value::Type::INT)? a.i : cpp_int(a.type==Value::Type::BOOL && a.b);
+    cpp_int y = (b.type==Value::Type::INT)? b.i : cpp_int(b.type==Value::Type::BOOL && b.b);
+    return Value::fromInt(x+y);
+}
+Value sub(const Value& a, const Value& b){
+    if (a.type==Value::Type::FLOAT || b.type==Value::Type::FLOAT){
+        double x = (a.type==Value::Type::FLOAT)? a.f : (a.type==Value::Type::INT? a.i.convert_to<double>() : (a.type==Value::Type::BOOL? (a.b?1.0:0.0):0.0));
+        double y = (b.type==Value::Type::FLOAT)? b.f : (b.type==Value::Type::INT? b.i.convert_to<double>() : (b.type==Value::Type::BOOL? (b.b?1.0:0.0):0.0));
+        return Value::fromFloat(x-y);
+    }
+    cpp_int x = (a.type==Value::Type::INT)? a.i : cpp_int(a.type==Value::Type::BOOL && a.b);
+    cpp_int y = (b.type==Value::Type::INT)? b.i : cpp_int(b.type==Value::Type::BOOL && b.b);
+    return Value::fromInt(x-y);
+}
+Value mul(const Value& a, const Value& b){
+    // string repeat
+    if (a.type==Value::Type::STR && (b.type==Value::Type::INT || b.type==Value::Type::BOOL)){
+        long long n = (b.type==Value::Type::INT)? b.i.convert_to<long long>() : (b.b?1:0);
+        if (n<=0) return Value::fromStr("");
+        string out; out.reserve(a.s.size()* (size_t)n);
+        for(long long i=0;i<n;i++) out+=a.s;
+        return Value::fromStr(out);
+    }
+    if (b.type==Value::Type::STR && (a.type==Value::Type::INT || a.type==Value::Type::BOOL)) return mul(b,a);
+    if (a.type==Value::Type::FLOAT || b.type==Value::Type::FLOAT){
+        double x = (a.type==Value::Type::FLOAT)? a.f : (a.type==Value::Type::INT? a.i.convert_to<double>() : (a.type==Value::Type::BOOL? (a.b?1.0:0.0):0.0));
+        double y = (b.type==Value::Type::FLOAT)? b.f : (b.type==Value::Type::INT? b.i.convert_to<double>() : (b.type==Value::Type::BOOL? (b.b?1.0:0.0):0.0));
+        return Value::fromFloat(x*y);
+    }
+    cpp_int x = (a.type==Value::Type::INT)? a.i : cpp_int(a.type==Value::Type::BOOL && a.b);
+    cpp_int y = (b.type==Value::Type::INT)? b.i : cpp_int(b.type==Value::Type::BOOL && b.b);
+    return Value::fromInt(x*y);
+}
+Value truediv(const Value& a, const Value& b){
+    double x = (a.type==Value::Type::FLOAT)? a.f : (a.type==Value::Type::INT? a.i.convert_to<double>() : (a.type==Value::Type::BOOL? (a.b?1.0:0.0):0.0));
+    double y = (b.type==Value::Type::FLOAT)? b.f : (b.type==Value::Type::INT? b.i.convert_to<double>() : (b.type==Value::Type::BOOL? (b.b?1.0:0.0):0.0));
+    return Value::fromFloat(x/y);
+}
+cpp_int floor_div_int(const cpp_int& a, const cpp_int& b){
+    cpp_int q = a / b; cpp_int r = a % b; // trunc toward zero
+    bool neg = ( (a<0) ^ (b<0) );
+    if (neg && r!=0) q -= 1;
+    return q;
+}
+cpp_int mod_int(const cpp_int& a, const cpp_int& b){
+    cpp_int r = a % b; // sign of a
+    if (r!=0 && ((r<0) != (b<0))) r += b;
+    return r;
+}
+Value floordiv(const Value& a, const Value& b){
+    if ((a.type==Value::Type::INT || a.type==Value::Type::BOOL) && (b.type==Value::Type::INT || b.type==Value::Type::BOOL)){
+        cpp_int x = (a.type==Value::Type::INT)? a.i : cpp_int(a.b?1:0);
+        cpp_int y = (b.type==Value::Type::INT)? b.i : cpp_int(b.b?1:0);
+        return Value::fromInt(floor_div_int(x,y));
+    }
+    // numeric floordiv
+    double x = (a.type==Value::Type::FLOAT)? a.f : (a.type==Value::Type::INT? a.i.convert_to<double>() : (a.type==Value::Type::BOOL? (a.b?1.0:0.0):0.0));
+    double y = (b.type==Value::Type::FLOAT)? b.f : (b.type==Value::Type::INT? b.i.convert_to<double>() : (b.type==Value::Type::BOOL? (b.b?1.0:0.0):0.0));
+    return Value::fromInt((cpp_int) floor(x/y));
+}
+Value mod(const Value& a, const Value& b){
+    // a % b = a - (a // b)*b
+    Value q = floordiv(a,b);
+    Value prod = mul(q,b);
+    if (a.type==Value::Type::FLOAT || b.type==Value::Type::FLOAT){
+        double x = (a.type==Value::Type::FLOAT)? a.f : (a.type==Value::Type::INT? a.i.convert_to<double>() : (a.type==Value::Type::BOOL? (a.b?1.0:0.0):0.0));
+        double p = (prod.type==Value::Type::FLOAT)? prod.f : (prod.type==Value::Type::INT? prod.i.convert_to<double>() : (prod.type==Value::Type::BOOL? (prod.b?1.0:0.0):0.0));
+        return Value::fromFloat(x - p);
+    }else{
+        cpp_int x = (a.type==Value::Type::INT)? a.i : cpp_int(a.type==Value::Type::BOOL && a.b);
+        cpp_int p = (prod.type==Value::Type::INT)? prod.i : cpp_int(prod.type==Value::Type::BOOL && prod.b);
+        return Value::fromInt(x - p);
+    }
+}
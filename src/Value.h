@@ -0,0 +1,58 @@
+#pragma once
+#ifndef PYTHON_INTERPRETER_VALUE_H
+#define PYTHON_INTERPRETER_VALUE_H
+
+#include <bits/stdc++.h>
+#include <boost/multiprecision/cpp_int.hpp>
+
+// Dynamic value type used by the interpreter
+struct Value {
+    enum class Type { NONE, BOOL, INT, FLOAT, STR } type{Type::NONE};
+    bool b{};
+    boost::multiprecision::cpp_int i{};
+    double f{};
+    std::string s{};
+
+    static Value None() { return Value(); }
+    static Value fromBool(bool v) { Value x; x.type=Type::BOOL; x.b=v; return x; }
+    static Value fromInt(const boost::multiprecision::cpp_int &v){ Value x; x.type=Type::INT; x.i=v; return x; }
+    static Value fromInt(long long v){ return fromInt(boost::multiprecision::cpp_int(v)); }
+    static Value fromFloat(double v){ Value x; x.type=Type::FLOAT; x.f=v; return x; }
+    static Value fromStr(std::string v){ Value x; x.type=Type::STR; x.s=std::move(v); return x; }
+};
+
+// type helpers
+bool isTruthy(const Value& v);
+std::string toString(const Value& v);
+Value add(const Value& a, const Value& b);
+Value sub(const Value& a, const Value& b);
+Value mul(const Value& a, const Value& b);
+Value truediv(const Value& a, const Value& b);
+Value floordiv(const Value& a, const Value& b);
+Value mod(const Value& a, const Value& b);
+// int-only kernels of floordiv and mod (floor rounding)
+boost::multiprecision::cpp_int floor_div_int(const boost::multiprecision::cpp_int& a, const boost::multiprecision::cpp_int& b);
+boost::multiprecision::cpp_int mod_int(const boost::multiprecision::cpp_int& a, const boost::multiprecision::cpp_int& b);
+// the same on int64; false when the divisor is 0 or the result overflows
+inline bool floor_div_small(int64_t a, int64_t b, int64_t& out){
+    if (b==0 || (b==-1 && a==INT64_MIN)) return false;
+    out = a / b;
+    if (a % b!=0 && ((a < 0)!=(b < 0))) --out;
+    return true;
+}
+inline bool mod_small(int64_t a, int64_t b, int64_t& out){
+    if (b==0) return false;
+    if (b==-1){ out = 0; return true; }
+    out = a % b;
+    if (out!=0 && ((out < 0)!=(b < 0))) out += b;
+    return true;
+}
+
+int cmp(const Value& a, const Value& b); // -1,0,1 for a<b, a==b, a>b (only for same-ish types)
+
+// parsing utils
+Value parseNumber(const std::string& text);
+std::string parseStringToken(const std::string& text);
+std::string parseFormatLiteral(const std::string& text);
+
+#endif // PYTHON_INTERPRETER_VALUE_H
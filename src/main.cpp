@@ -1,18 +1,230 @@
-#include "Evalvisitor.h"
-#include "Python3Lexer.h"
-#include "Python3Parser.h"
-#include "antlr4-runtime.h"
+#include "Compiler.h"
+#include "Frontend.h"
+#include "Interpreter.h"
+#include "SourceFile.h"
+#include "VM.h"
+#include <fstream>
 #include <iostream>
-using namespace antlr4;
+#include <sstream>
+
+// The (usually mmap'ed) script text is released when this returns, like
+// everything else parsing used.
+static Program parseProgram(const char *path, bool use_antlr) {
+    SourceFile source = path ? SourceFile::open(path) : SourceFile::fromStdin();
+    return parseSource(source.text(), use_antlr);
+}
+
+static int usage(const char *argv0) {
+    std::cerr << "usage: " << argv0 << " [--engine=native|antlr] [--stackless [--stack-budget=MiB] [--no-jit]]"
+              << " [--profile=folded.txt] [--stats] [--trace=trace.json]"
+              << " [--memory-report] [--memory-limit=MiB] [--max-steps=N] [--time-limit=SECONDS]"
+              << " [script.py | --batch=LIST]\n";
+    return 2;
+}
+
+// Folded stacks go to path, the per-line table to stderr after the script's output.
+static void finishProfile(Profiler &profiler, const std::string &path) {
+    profiler.stop();
+    std::cout.flush();
+    std::ofstream out(path);
+    if (out) profiler.writeFolded(out);
+    else std::cerr << "profile: cannot write " << path << '\n';
+    profiler.writeLineTable(std::cerr);
+}
+
+static void finishStats(Stats &stats) {
+    stats.finish();
+    std::cout.flush();
+    stats.report(std::cerr);
+}
+
+static void finishTrace(const Trace &trace, const std::string &path) {
+    std::ofstream out(path);
+    if (out) trace.write(out);
+    else std::cerr << "trace: cannot write " << path << '\n';
+}
+
+struct Options {
+    bool use_antlr = false;
+    bool stackless = false;
+    bool jit = true;
+    size_t stack_budget = VM::DEFAULT_STACK_BUDGET;
+    std::string profile_path;
+    bool count = false;
+    std::string trace_path;
+    bool memory_report = false;
+    size_t memory_limit = 0;
+    uint64_t max_steps = 0;
+    double time_limit = 0;
+};
+
+// Parses and runs one script (stdin when path is null) with the engine and
+// tools opt asks for; its output goes to cout. Errors are thrown.
+static void runScript(const Options &opt, const char *path) {
+    bool memory = opt.memory_report || opt.memory_limit;
+    if (memory) Memory::reset(); // nothing carries over from a batch's earlier scripts
+    if (memory) Memory::beginParse();
+    Program program = parseProgram(path, opt.use_antlr);
+    if (memory) Memory::endParse();
+    std::unique_ptr<Profiler> profiler;
+    if (!opt.profile_path.empty()) profiler = std::make_unique<Profiler>(program);
+    std::unique_ptr<Stats> stats;
+    if (opt.count) stats = std::make_unique<Stats>(program);
+    std::unique_ptr<Trace> trace;
+    if (!opt.trace_path.empty()) trace = std::make_unique<Trace>(program);
+    std::unique_ptr<Budget> budget;
+    if (opt.max_steps || opt.time_limit) budget = std::make_unique<Budget>(opt.max_steps, opt.time_limit);
+    Instrumentation tools{profiler.get(), stats.get(), trace.get(), budget.get()};
+    try {
+        if (opt.stackless) {
+            // interpreted frames live on the VM's heap stack, not the C++ stack
+            Module module = Compiler(program).compile();
+            if (profiler) profiler->start();
+            VM(program, module, opt.stack_budget, opt.jit, tools).run();
+        } else {
+            if (profiler) profiler->start();
+            Interpreter(program, tools).run();
+        }
+    } catch (...) {
+        // a script that fails is still reported up to the error
+        if (profiler) finishProfile(*profiler, opt.profile_path);
+        if (stats) finishStats(*stats);
+        if (trace) finishTrace(*trace, opt.trace_path);
+        if (opt.memory_report && !Memory::limitExceeded()) {
+            std::cout.flush();
+            Memory::report(std::cerr);
+        }
+        throw;
+    }
+    if (profiler) finishProfile(*profiler, opt.profile_path);
+    if (stats) finishStats(*stats);
+    if (trace) finishTrace(*trace, opt.trace_path);
+    if (opt.memory_report) {
+        std::cout.flush();
+        Memory::report(std::cerr);
+    }
+}
+
+// The message for a script that failed, as it is printed after "name: ".
+static std::string failure(const std::exception &e) {
+    if (dynamic_cast<const SyntaxError *>(&e)) return std::string("SyntaxError: ") + e.what();
+    return e.what();
+}
+
+// Sends cout to a file for as long as it lives.
+class RedirectOutput {
+public:
+    explicit RedirectOutput(std::ofstream &file) : saved_(std::cout.rdbuf(file.rdbuf())) {}
+    ~RedirectOutput() {
+        std::cout.flush();
+        std::cout.rdbuf(saved_);
+    }
+
+private:
+    std::streambuf *saved_;
+};
+
+// Runs every script listed in list_path in this one process, each with fresh
+// engine state. A line is "SCRIPT [OUTPUT]"; the output defaults to SCRIPT
+// with its extension replaced by .actual. Blank lines and # comments are
+// skipped. A failing script is reported on stderr and the batch goes on.
+// The ANTLR parser's deserialized ATN and its DFA cache are process-wide,
+// so after the first script every parse starts warm.
+static int runBatch(const Options &opt, const std::string &list_path) {
+    std::ifstream list(list_path);
+    if (!list) {
+        std::cerr << "batch: cannot read " << list_path << '\n';
+        return 2;
+    }
+    auto start = std::chrono::steady_clock::now();
+    size_t scripts = 0, failed = 0;
+    std::string line;
+    while (std::getline(list, line)) {
+        std::istringstream fields(line);
+        std::string script, output;
+        if (!(fields >> script) || script[0] == '#') continue;
+        if (!(fields >> output)) {
+            size_t slash = script.find_last_of('/');
+            size_t dot = script.find_last_of('.');
+            output = (dot != std::string::npos && (slash == std::string::npos || dot > slash) ? script.substr(0, dot)
+                                                                                            : script) + ".actual";
+        }
+        ++scripts;
+        std::ofstream file(output);
+        if (!file) {
+            std::cerr << script << ": cannot write " << output << '\n';
+            ++failed;
+            continue;
+        }
+        try {
+            RedirectOutput redirect(file);
+            runScript(opt, script.c_str());
+        } catch (const std::exception &e) {
+            std::cerr << script << ": " << failure(e) << '\n';
+            ++failed;
+        }
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << "batch: " << scripts << " scripts, " << failed << " failed, " << (long long)ms << " ms\n";
+    return failed ? 1 : 0;
+}
 
 int main(int argc, const char *argv[]) {
-    ANTLRInputStream input(std::cin);
-    Python3Lexer lexer(&input);
-    CommonTokenStream tokens(&lexer);
-    tokens.fill();
-    Python3Parser parser(&tokens);
-    tree::ParseTree *tree = parser.file_input();
-    EvalVisitor visitor;
-    visitor.visit(tree);
+    Options opt;
+    std::string batch;
+    const char *path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--engine=antlr") opt.use_antlr = true;
+        else if (arg == "--engine=native") opt.use_antlr = false;
+        else if (arg == "--stackless") opt.stackless = true;
+        else if (arg == "--no-jit") opt.jit = false;
+        else if (arg == "--stats") opt.count = true;
+        else if (arg.rfind("--stack-budget=", 0) == 0) {
+            char *end = nullptr;
+            unsigned long long mib = strtoull(arg.c_str() + 15, &end, 10);
+            if (*end || mib == 0) return usage(argv[0]);
+            opt.stack_budget = (size_t)mib << 20;
+        } else if (arg.rfind("--profile=", 0) == 0) {
+            opt.profile_path = arg.substr(10);
+            if (opt.profile_path.empty()) return usage(argv[0]);
+        } else if (arg == "--memory-report") opt.memory_report = true;
+        else if (arg.rfind("--memory-limit=", 0) == 0) {
+            char *end = nullptr;
+            unsigned long long mib = strtoull(arg.c_str() + 15, &end, 10);
+            if (*end || mib == 0) return usage(argv[0]);
+            opt.memory_limit = (size_t)mib << 20;
+        } else if (arg.rfind("--trace=", 0) == 0) {
+            opt.trace_path = arg.substr(8);
+            if (opt.trace_path.empty()) return usage(argv[0]);
+        } else if (arg.rfind("--max-steps=", 0) == 0) {
+            char *end = nullptr;
+            opt.max_steps = strtoull(arg.c_str() + 12, &end, 10);
+            if (*end || opt.max_steps == 0) return usage(argv[0]);
+        } else if (arg.rfind("--time-limit=", 0) == 0) {
+            char *end = nullptr;
+            opt.time_limit = strtod(arg.c_str() + 13, &end);
+            if (*end || !(opt.time_limit > 0)) return usage(argv[0]);
+        } else if (arg.rfind("--batch=", 0) == 0) {
+            batch = arg.substr(8);
+            if (batch.empty()) return usage(argv[0]);
+        } else if (arg.size() > 1 && arg[0] == '-') return usage(argv[0]);
+        else path = argv[i];
+    }
+    // the profile and the trace each go to one file
+    if (!batch.empty() && (path || !opt.profile_path.empty() || !opt.trace_path.empty())) return usage(argv[0]);
+    if (opt.memory_report || opt.memory_limit) Memory::enable(opt.memory_limit);
+    if (!batch.empty()) return runBatch(opt, batch);
+    try {
+        runScript(opt, path);
+    } catch (const SyntaxError &e) {
+        std::cout.flush();
+        std::cerr << failure(e) << '\n';
+        return 1;
+    } catch (const std::exception &e) {
+        std::cout.flush();
+        std::cerr << argv[0] << ": " << failure(e) << '\n';
+        return 1;
+    }
     return 0;
 }
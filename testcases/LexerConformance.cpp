@@ -0,0 +1,140 @@
+// Lexer conformance: tokenizes every .in file under the given directories
+// with NativeLexer and with the generated Python3Lexer it replaced, and
+// reports the first token where the two streams disagree in type, line or
+// text. The one documented difference is tolerated: between the quotes of
+// an f-string (outside {...}) the generated lexer can split the literal
+// into NAME and keyword tokens, so each such run is compared as the source
+// text it spans rather than token by token.
+#include "NativeLexer.h"
+#include "Python3Lexer.h"
+#include "antlr4-runtime.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace {
+
+struct Token {
+    size_t type;
+    size_t line;
+    size_t begin, end; // code point span [begin, end) in the source
+    string text;
+};
+
+// Layout tokens are synthesized with different spans and texts, and the
+// generated lexer stamps them with the line after the break; only their
+// type is compared.
+bool isLayout(size_t type){
+    return type==TK_NEWLINE || type==TK_INDENT || type==TK_DEDENT || type==TK_EOF;
+}
+
+// Merges each run of tokens between an f-string's quotes (outside {...})
+// into one FORMAT_STRING_LITERAL spanning the same source.
+vector<Token> mergeFormatLiterals(const vector<Token>& in, antlr4::ANTLRInputStream& source){
+    vector<Token> out;
+    vector<bool> expr_mode; // one entry per open f-string
+    for (const Token& t : in){
+        bool literal = !expr_mode.empty() && !expr_mode.back();
+        if (!literal && t.type==TK_FORMAT_QUOTATION) expr_mode.push_back(false);
+        else if (!literal && t.type==TK_CLOSE_BRACE && !expr_mode.empty()) expr_mode.back() = false;
+        else if (literal && t.type==TK_OPEN_BRACE) expr_mode.back() = true;
+        else if (literal && t.type==TK_QUOTATION) expr_mode.pop_back();
+        else if (literal){
+            if (!out.empty() && out.back().type==TK_FORMAT_STRING_LITERAL) out.back().end = t.end;
+            else{
+                out.push_back(t);
+                out.back().type = TK_FORMAT_STRING_LITERAL;
+            }
+            out.back().text = source.getText(antlr4::misc::Interval(out.back().begin, out.back().end - 1));
+            continue;
+        }
+        out.push_back(t);
+    }
+    return out;
+}
+
+vector<Token> nativeTokens(const string& text, antlr4::ANTLRInputStream& source){
+    // byte offset -> index of the code point it belongs to
+    vector<size_t> index(text.size() + 1);
+    size_t cp = 0;
+    for (size_t i = 0; i < text.size(); ++i){
+        if (((unsigned char)text[i] & 0xC0)!=0x80) ++cp;
+        index[i] = cp - 1;
+    }
+    index[text.size()] = cp;
+    TokenBuffer buffer = NativeLexer(text).run();
+    vector<Token> tokens;
+    for (const TokenRecord& r : buffer.tokens){
+        size_t begin = index[r.begin];
+        size_t end = r.length ? index[r.begin + r.length - 1] + 1 : begin;
+        tokens.push_back({r.type, r.line, begin, end, string(buffer.text(r))});
+    }
+    return mergeFormatLiterals(tokens, source);
+}
+
+vector<Token> generatedTokens(antlr4::ANTLRInputStream& source){
+    Python3Lexer lexer(&source);
+    lexer.removeErrorListeners();
+    vector<Token> tokens;
+    for (;;){
+        unique_ptr<antlr4::Token> t = lexer.nextToken();
+        size_t type = t->getType()==antlr4::Token::EOF ? TK_EOF : t->getType();
+        if (t->getChannel()==antlr4::Token::DEFAULT_CHANNEL){
+            tokens.push_back({type, t->getLine(), t->getStartIndex(), t->getStopIndex() + 1, t->getText()});
+        }
+        if (type==TK_EOF) break;
+    }
+    return mergeFormatLiterals(tokens, source);
+}
+
+string describe(const Token& t){
+    return "type " + to_string(t.type) + " line " + to_string(t.line) + " '" + t.text + "'";
+}
+
+// Empty when the streams agree, else where they first differ.
+string compare(const vector<Token>& native, const vector<Token>& generated){
+    size_t n = min(native.size(), generated.size());
+    for (size_t i = 0; i < n; ++i){
+        const Token& a = native[i];
+        const Token& b = generated[i];
+        bool same = a.type==b.type && (isLayout(a.type) || (a.line==b.line && a.text==b.text));
+        if (!same) return "token " + to_string(i) + ": native " + describe(a) + ", generated " + describe(b);
+    }
+    if (native.size()!=generated.size()){
+        return "native has " + to_string(native.size()) + " tokens, generated " + to_string(generated.size());
+    }
+    return "";
+}
+
+} // namespace
+
+int main(int argc, const char* argv[]){
+    if (argc < 2){
+        cerr << "usage: " << argv[0] << " testcase-dir...\n";
+        return 2;
+    }
+    int checked = 0, failed = 0;
+    for (int i = 1; i < argc; ++i){
+        vector<fs::path> inputs;
+        for (const fs::directory_entry& e : fs::directory_iterator(argv[i])){
+            if (e.path().extension()==".in") inputs.push_back(e.path());
+        }
+        sort(inputs.begin(), inputs.end());
+        for (const fs::path& path : inputs){
+            ifstream in(path, ios::binary);
+            string text(istreambuf_iterator<char>(in), {});
+            antlr4::ANTLRInputStream source(text);
+            vector<Token> native = nativeTokens(text, source);
+            string diff = compare(native, generatedTokens(source));
+            ++checked;
+            if (!diff.empty()){
+                cout << path.parent_path().filename().string() << "/" << path.filename().string() << ": " << diff << '\n';
+                ++failed;
+            }
+        }
+    }
+    cout << checked << " files, " << failed << " with differing tokens\n";
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,9 @@
+# A constant operation that raises must raise when it runs, after the output
+# of everything before it, not while the script is parsed (and not at all if
+# it never runs).
+def never():
+    return 2.0e400 // 3
+
+print(1)
+print(1.0e400 // 1)
+print(2)
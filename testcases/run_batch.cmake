@@ -0,0 +1,26 @@
+# Runs every INPUT_DIR/*.in in one EXE ARGS --batch process, each writing to
+# WORK_DIR, and compares every output byte-for-byte with its .out.
+file(GLOB inputs ${INPUT_DIR}/*.in)
+file(MAKE_DIRECTORY ${WORK_DIR})
+set(list "")
+foreach(input ${inputs})
+	get_filename_component(name ${input} NAME_WE)
+	string(APPEND list "${input} ${WORK_DIR}/${name}.out\n")
+endforeach()
+file(WRITE ${WORK_DIR}/batch.list "${list}")
+separate_arguments(args UNIX_COMMAND "${ARGS}")
+execute_process(COMMAND ${EXE} ${args} --batch=${WORK_DIR}/batch.list
+	ERROR_VARIABLE errors
+	RESULT_VARIABLE rc)
+if(NOT rc EQUAL 0)
+	message(FATAL_ERROR "batch exited with ${rc}\n${errors}")
+endif()
+foreach(input ${inputs})
+	get_filename_component(name ${input} NAME_WE)
+	string(REGEX REPLACE "\\.in$" ".out" expected_path ${input})
+	file(READ ${expected_path} expected)
+	file(READ ${WORK_DIR}/${name}.out actual)
+	if(NOT actual STREQUAL expected)
+		message(FATAL_ERROR "${input}: batch output differs from ${expected_path}")
+	endif()
+endforeach()
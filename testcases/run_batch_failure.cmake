@@ -0,0 +1,23 @@
+# A batch whose middle script fails (std::length_error from a huge string
+# repeat) still runs the scripts after it, prints its summary and exits 1.
+file(MAKE_DIRECTORY ${WORK_DIR})
+file(WRITE ${WORK_DIR}/first.py "print(1)\n")
+file(WRITE ${WORK_DIR}/huge.py "print(\"ab\" * 100000000000000000000)\n")
+file(WRITE ${WORK_DIR}/last.py "print(2)\n")
+file(REMOVE ${WORK_DIR}/last.out)
+file(WRITE ${WORK_DIR}/batch.list
+	"${WORK_DIR}/first.py ${WORK_DIR}/first.out\n${WORK_DIR}/huge.py ${WORK_DIR}/huge.out\n${WORK_DIR}/last.py ${WORK_DIR}/last.out\n")
+separate_arguments(args UNIX_COMMAND "${ARGS}")
+execute_process(COMMAND ${EXE} ${args} --batch=${WORK_DIR}/batch.list
+	ERROR_VARIABLE errors
+	RESULT_VARIABLE rc)
+if(NOT rc EQUAL 1)
+	message(FATAL_ERROR "batch exited with ${rc}, expected 1\n${errors}")
+endif()
+if(NOT errors MATCHES "batch: 3 scripts, 1 failed")
+	message(FATAL_ERROR "no batch summary\n${errors}")
+endif()
+file(READ ${WORK_DIR}/last.out actual)
+if(NOT actual STREQUAL "2\n")
+	message(FATAL_ERROR "the script after the failure did not run\n${errors}")
+endif()
@@ -0,0 +1,21 @@
+# Memory accounting restarts for every script of a batch: two scripts over
+# the soft limit each fail with their own report, and a small one after
+# them reports only its own peak.
+file(MAKE_DIRECTORY ${WORK_DIR})
+file(WRITE ${WORK_DIR}/small.py "print(2)\n")
+file(WRITE ${WORK_DIR}/batch.list
+	"${SCRIPT} ${WORK_DIR}/big1.out\n${SCRIPT} ${WORK_DIR}/big2.out\n${WORK_DIR}/small.py ${WORK_DIR}/small.out\n")
+separate_arguments(args UNIX_COMMAND "${ARGS}")
+execute_process(COMMAND ${EXE} ${args} --memory-report --memory-limit=1 --batch=${WORK_DIR}/batch.list
+	ERROR_VARIABLE errors
+	RESULT_VARIABLE rc)
+string(REGEX MATCHALL "MemoryError: soft limit" limits "${errors}")
+list(LENGTH limits limit_count)
+string(REGEX MATCHALL "memory: live" reports "${errors}")
+list(LENGTH reports report_count)
+if(NOT rc EQUAL 1 OR NOT limit_count EQUAL 2 OR NOT report_count EQUAL 3)
+	message(FATAL_ERROR "expected 2 MemoryErrors and 3 reports, exit 1 (got ${rc})\n${errors}")
+endif()
+if(NOT errors MATCHES "memory: live [0-9.]+ MiB, peak 0\\.[0-9]+ MiB, soft limit 1 MiB\n[^\n]*\n[^\n]*\nstrings +0\\.000")
+	message(FATAL_ERROR "the last script's report carries earlier peaks\n${errors}")
+endif()
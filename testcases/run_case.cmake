@@ -0,0 +1,14 @@
+# Runs one testcase: EXE ARGS < INPUT, compared byte-for-byte with EXPECTED.
+separate_arguments(args UNIX_COMMAND "${ARGS}")
+execute_process(COMMAND ${EXE} ${args}
+	INPUT_FILE ${INPUT}
+	OUTPUT_VARIABLE actual
+	ERROR_VARIABLE errors
+	RESULT_VARIABLE rc)
+if(NOT rc EQUAL 0)
+	message(FATAL_ERROR "${INPUT}: exited with ${rc}\n${errors}")
+endif()
+file(READ ${EXPECTED} expected)
+if(NOT actual STREQUAL expected)
+	message(FATAL_ERROR "${INPUT}: output differs from ${EXPECTED}")
+endif()
@@ -0,0 +1,22 @@
+# Non-tail recursion 200000 levels deep; the tree-walking engine would
+# overflow the native stack long before this.
+def depth(n):
+    if n == 0:
+        return 0
+    return depth(n - 1) + 1
+
+def ack(m, n):
+    if m == 0:
+        return n + 1
+    if n == 0:
+        return ack(m - 1, 1)
+    return ack(m - 1, ack(m, n - 1))
+
+def count(n, acc=0):
+    if n == 0:
+        return acc
+    return count(n - 1, acc=acc + n)
+
+print(depth(200000))
+print(ack(2, 300))
+print(count(1000000))
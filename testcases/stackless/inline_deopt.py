@@ -0,0 +1,38 @@
+# Hot calls the VM has inlined must notice when their callee is redefined:
+# sq is replaced after 200 calls (long past the inlining threshold), again
+# with a body that cannot be inlined, and scale flips between two bodies
+# every 100 calls, more often than a site is allowed to re-inline.
+def sq(x):
+    return x * x
+
+def scale(x, k):
+    return x * k + 1
+
+total = 0
+i = 0
+while i < 1000:
+    if i == 200:
+        def sq(x):
+            return x * x + 1
+    if i == 600:
+        def sq(x):
+            if x < 0:
+                return 0
+            return x * x * x
+    total += sq(i)
+    i += 1
+print(total)
+
+acc = 0
+j = 0
+while j < 1000:
+    if j % 200 == 100:
+        def scale(x, k):
+            return x * k - 7
+    if j % 200 == 0:
+        def scale(x, k):
+            return x + k
+    acc = (acc + scale(j, 3)) % 1000003
+    j += 1
+print(acc)
+print(sq(-5), sq(3), scale(2, 2))
@@ -0,0 +1,94 @@
+# Hot while-loops that the VM compiles to machine code, checked against
+# the interpreted result: overflow into big ints part-way through a loop,
+# floor division and modulo of negative operands, break/continue, nested
+# loops, module-level globals and loops that exit on a falsy counter.
+def overflow(n):
+    x = 1
+    i = 0
+    while i < n:
+        x = x * 3 + 1
+        i += 1
+    return x
+
+def floors(n):
+    s = 0
+    i = -n
+    while i < n:
+        s = s + i // 7 - i % 5 + (i * 3) // -4 + i % -3 + i // 8 + i % 16
+        i += 1
+    return s
+
+def nested(n):
+    total = 0
+    i = 0
+    while i < n:
+        j = 0
+        while j < i:
+            if (i + j) % 3 == 0:
+                j += 1
+                continue
+            total += i * j
+            if total > 1000000:
+                break
+            j += 1
+        i += 1
+    return total
+
+def countdown(n):
+    steps = 0
+    while n:
+        n -= 1
+        steps = steps + 2
+    return steps
+
+def collatz(n):
+    steps = 0
+    while True:
+        if n == 1:
+            break
+        if n % 2 == 0:
+            n = n // 2
+        else:
+            n = 3 * n + 1
+        steps += 1
+    return steps
+
+def mixed(n):
+    # the accumulator turns into a float half-way
+    acc = 0
+    i = 0
+    while i < n:
+        if i == n // 2:
+            acc = acc + 0.5
+        acc = acc + i
+        i += 1
+    return acc
+
+print(overflow(10))
+print(overflow(200))
+print(floors(500))
+print(nested(300))
+print(countdown(1000))
+print(collatz(27), collatz(97), collatz(871))
+print(mixed(1000))
+
+g = 0
+k = 0
+while k < 5000:
+    g = g + k * k - (k // 3)
+    k += 1
+print(g, k)
+
+big = 1180591620717411303424
+m = 0
+while m < 300:
+    big = big - 1
+    m = m + 1
+print(big, m)
+
+neg = -9223372036854775807
+t = 0
+while t < 300:
+    neg = neg - 1
+    t += 1
+print(neg)
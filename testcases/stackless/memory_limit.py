@@ -0,0 +1,10 @@
+# Builds an 8 MiB string and a 4 MiB int; run with --memory-limit=1 it must
+# stop with a MemoryError instead of finishing.
+s = "ab"
+n = 3
+i = 0
+while i < 22:
+    s = s + s
+    n = n * n
+    i += 1
+print(len(s))
@@ -0,0 +1,11 @@
+# Never finishes; only a step budget or a time limit stops it.
+def step(n):
+    return n + 1
+
+i = 0
+while i < 1000:
+    i = step(i)
+print(i)
+k = 0
+while True:
+    k = k + 1